@@ -648,7 +648,7 @@ void forth_init() {
     dict_compile();                      ///< compile dictionary
     dict_validate();                     ///< collect XT0, and check xtoff range
 }
-int forth_vm(const char *line, void(*hook)(int, const char*)) {
+static int _forth_vm(const char *line, void(*hook)(int, const char*)) {
     auto time_up = []() {                /// * time slice up
         static long t0 = 0;              /// * real-time support, 10ms = 100Hz
         long t1 = millis();              ///> check timing
@@ -674,6 +674,15 @@ int forth_vm(const char *line, void(*hook)(int, const char*)) {
     
     return yield;
 }
+///
+///> platform/main.cpp takes a non-zero return as bye, so resume
+///  a yielded VM here until the line is done (bye exits by itself)
+///
+int forth_vm(const char *line, void(*hook)(int, const char*)) {
+    while (_forth_vm(line, hook));       /// * until VM stops yielding
+    return 0;
+}
+void forth_teardown() {}                 ///< nothing to release, for main.cpp
 ///====================================================================
 ///
 ///@name IO functions
@@ -2,7 +2,9 @@
 #define __EFORTH_SRC_CEFORTH_H
 #include <cstdio>
 #include <cstdint>      // uintxx_t
-#include <string.h>     // string, strlen
+#include <cstdlib>      // exit, strtol, abs, rand
+#include <string>       // string
+#include <string.h>     // strlen
 #include "config.h"     // configuation and cross-platform support
 using namespace std;
 ///
@@ -4,6 +4,7 @@
 ///
 #include <iostream>      // cin, cout
 #include <fstream>       // ifstream
+#include <sstream>       // istringstream
 #include <cstdint>
 
 #ifdef __APPLE__
@@ -14,6 +15,11 @@
 #else // Linux || Cygwin
 #include <sys/sysinfo.h>
 #endif
+#if !(_WIN32 || _WIN64)
+#include <unistd.h>      // fork
+#include <sys/wait.h>    // wait
+#include <sys/mman.h>    // shm_unlink
+#endif
 
 using namespace std;
 
@@ -80,19 +86,68 @@ void forth_include(const char *fn) {
 
     ifile.close();
 }
-///====================================================================
 ///
-/// main program - Note: Arduino and ESP32 have their own main-loop
+///> run Forth on an input stream, as a single process or as one node
 ///
-int main(int ac, char* av[]) {
+int run(istream &in) {
     forth_init();                             ///> initialize dictionary
     
     mem_stat();                               ///> show memory status
     srand((int)time(0));                      ///> seed random generator
-    outer(cin);                               ///> Forth outer interpreter
+    outer(in);                                ///> Forth outer interpreter
     
     forth_teardown();                         ///> clean up before we go
     cout << APP_VERSION << " Done!" << endl;
     return 0;
 }
+#if !(_WIN32 || _WIN64)
+///
+///> launcher - run the script from stdin on np processes (nodes)
+///
+/// Note: nodes share inboxes in POSIX shared memory named by E4_MPI,
+///       and get E4_NODE for its rank, so send reaches a VM on another
+///       node by tid (see gid). Only the name is set here, so this
+///       main links with any eForth build, with or without DO_MPI
+///
+int launch(int np) {
+    string src((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+    string nm = "/eforth." + to_string(getpid());
+    if (np < 1) {
+        cerr << "-np " << np << ": needs 1 or more processes" << endl;
+        return 1;
+    }
+    setenv("E4_MPI",   nm.c_str(), 1);
+    setenv("E4_NODES", to_string(np).c_str(), 1);
+    for (int r = 0; r < np; r++) {
+        pid_t pid = fork();
+        if (pid < 0) { perror("fork"); break; }
+        if (pid == 0) {                       /// * node r
+            setenv("E4_NODE", to_string(r).c_str(), 1);
+            istringstream in(src);
+            exit(run(in));
+        }
+    }
+    int st, rc = 0;
+    while (wait(&st) > 0) {                   ///> wait for all nodes
+        if (!WIFEXITED(st) || WEXITSTATUS(st)) rc = 1;
+    }
+    shm_unlink(nm.c_str());                   ///> remove shared inboxes
+    return rc;
+}
+#endif // !(_WIN32 || _WIN64)
+///====================================================================
+///
+/// main program - Note: Arduino and ESP32 have their own main-loop
+///
+///   eforth            - interactive, or script from stdin
+///   eforth -np 4      - run script from stdin on 4 processes
+///
+int main(int ac, char* av[]) {
+#if !(_WIN32 || _WIN64)
+    for (int i = 1; i < ac - 1; i++) {
+        if (string(av[i]) == "-np") return launch(atoi(av[i + 1]));
+    }
+#endif // !(_WIN32 || _WIN64)
+    return run(cin);
+}
 ///====================================================================
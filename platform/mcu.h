@@ -20,7 +20,7 @@ const char *APP_VERSION = "eForth v5.0";
 #include "../src/ceforth.h"
 extern void forth_init();
 extern int  forth_vm(const char *cmd, void(*hook)(int, const char*));
-extern FV<Code*> dict;
+extern FD<Code*> dict;
 ///====================================================================
 ///
 ///> Memory statistics - for heap, stack, external memory debugging
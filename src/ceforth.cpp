@@ -11,7 +11,7 @@ using namespace std;
 ///
 ///> Forth VM state variables
 ///
-FV<Code*> dict;                        ///< Forth dictionary
+FD<Code*> dict;                        ///< Forth dictionary
 Code      *last;                       ///< cached dict[-1]
 ///
 ///> macros to reduce verbosity (but harder to single-step debug)
@@ -30,12 +30,48 @@ Code      *last;                       ///< cached dict[-1]
 #define BRAN(p)      ((p).merge(last->pf))          /** add branching code */
 #define NEST(pf)     for (auto w : (pf)) w->nest(vm)
 #define UNNEST()     throw 0
+#define PTGT()       (_ptgt(vm))                    /** par{ branch target */
+///
+///> | and }par outside of par{ would patch the last if, begin, or do
+///
+Bran *_ptgt(VM &vm) {
+    Code      *t  = dict[-1];          ///< branch being compiled, a Tmp
+    FV<Code*> &pf = dict[-2]->pf;
+    if (!vm.compile || t->xt || *t->name || !pf.size() || pf[-1]->xt != _par)
+        throw runtime_error("outside par{");
+    return (Bran*)pf[-1];
+}
+///
+///> atomic access to variable cells shared by tasks
+///
+/// Note: all atomic words are sequentially consistent (seq_cst), so
+///       plain @ and ! done before an atomic! (or atomic+!, cas) are
+///       visible to any task that later reads its value with atomic@
+///
+#define AVAR(i_w)    (*reinterpret_cast<atomic<DU>*>(&VAR(i_w)))
+static_assert(sizeof(atomic<DU>) == sizeof(DU), "atomic<DU> must overlay a cell");
+
+template<typename F>
+DU _afetch(atomic<DU> &a, F op) {      ///< read-modify-write by CAS loop
+    DU o = a.load();
+    while (!a.compare_exchange_weak(o, op(o)));
+    return o;                          /// * value before update
+}
+#if USE_FLOAT                          /// * atomic<float> has no fetch ops in C++17
+DU _afetch_add(atomic<DU> &a, DU n) { return _afetch(a, [n](DU o) { return o + n; }); }
+DU _afetch_or(atomic<DU> &a, DU n)  { return _afetch(a, [n](DU o) { return (DU)(UINT(o) | UINT(n)); }); }
+DU _afetch_and(atomic<DU> &a, DU n) { return _afetch(a, [n](DU o) { return (DU)(UINT(o) & UINT(n)); }); }
+#else // !USE_FLOAT
+DU _afetch_add(atomic<DU> &a, DU n) { return a.fetch_add(n); }
+DU _afetch_or(atomic<DU> &a, DU n)  { return a.fetch_or(n);  }
+DU _afetch_and(atomic<DU> &a, DU n) { return a.fetch_and(n); }
+#endif // USE_FLOAT
 ///
 ///> Forth Dictionary Assembler
 /// @note:
 ///    1. Dictionary construction sequence
 ///       * Code rom[] in statically build in compile-time
-///       * vector<Code*> dict is populated in forth_init, i.e. first thing in main()
+///       * FD<Code*> dict is populated in forth_init, i.e. first thing in main()
 ///    2. Macro CODE/IMMD use __COUNTER__ for array token/index can potetially
 ///       make the dictionary static but need to be careful the
 ///       potential issue comes with it.
@@ -125,24 +161,24 @@ const Code rom[] {               ///< Forth dictionary
     /// @defgroup IO ops
     /// @{
     CODE("base",   PUSH((vm.id << 16) | BASE_NODE)),   /// dict[0]->pf[0]->q[id] used for base
-    CODE("decimal",dot(RDX, *BASE=10)),
-    CODE("hex",    dot(RDX, *BASE=16)),
+    CODE("decimal",dot(vm, RDX, *BASE=10)),
+    CODE("hex",    dot(vm, RDX, *BASE=16)),
     CODE("bl",     PUSH(0x20)),
-    CODE("cr",     dot(CR)),
-    CODE(".",      dot(DOT,  POP())),
-    CODE("u.",     dot(UDOT, POP())),
-    CODE(".r",     IU w = POPI(); dotr(w, POP(), *BASE)),
-    CODE("u.r",    IU w = POPI(); dotr(w, POP(), *BASE, true)),
-    CODE("type",   POP(); U32 i_w=POPI(); pstr(STR(i_w))),
+    CODE("cr",     dot(vm, CR)),
+    CODE(".",      dot(vm, DOT,  POP())),
+    CODE("u.",     dot(vm, UDOT, POP())),
+    CODE(".r",     IU w = POPI(); dotr(vm, w, POP(), *BASE)),
+    CODE("u.r",    IU w = POPI(); dotr(vm, w, POP(), *BASE, true)),
+    CODE("type",   POP(); U32 i_w=POPI(); pstr(vm, STR(i_w))),
     CODE("key",    PUSH(key())),
-    CODE("emit",   dot(EMIT, POP())),
-    CODE("space",  dot(SPCS, DU1)),
-    CODE("spaces", dot(SPCS, POP())),
+    CODE("emit",   dot(vm, EMIT, POP())),
+    CODE("space",  dot(vm, SPCS, DU1)),
+    CODE("spaces", dot(vm, SPCS, POP())),
     /// @}
     /// @defgroup Literal ops
     /// @{
     IMMD("(",      scan(')')),
-    IMMD(".(",     pstr(scan(')'))),
+    IMMD(".(",     pstr(vm, scan(')'))),
     IMMD("\\",     scan('\n')),
     IMMD("s\"",
          const char *s = word('"'); if (!s) return;
@@ -156,7 +192,7 @@ const Code rom[] {               ///< Forth dictionary
     IMMD(".\"",
          const char *s = word('"'); if (!s) return;
          if (vm.compile) ADD_W(new Str(s+1));
-         else            pstr(s+1)),
+         else            pstr(vm, s+1)),
     /// @}
     /// @defgroup Branching ops
     /// @brief - if...then, if...else...then
@@ -229,11 +265,38 @@ const Code rom[] {               ///< Forth dictionary
          ADD_W(new Bran(_loop));
          DICT_PUSH(new Tmp())),
     CODE("i",      PUSH(RS[-1])),
+    CODE("j",      PUSH(RS[-2])),                /// * index of outer loop
     CODE("leave",  UNNEST()),                  /// * exit loop
     IMMD("loop",
          Bran *b = BTGT();
          BRAN(b->pf);                          /// * do.{pf}.loop
          DICT_POP()),
+    IMMD("pdo",                                /// * parallel do..loop
+         ADD_W(new Bran(_tor2));               ///< ( limit first -- )
+         ADD_W(new Bran(_ploop));
+         DICT_PUSH(new Tmp())),
+    IMMD("ploop",
+         Bran *b = BTGT();
+         BRAN(b->pf);                          /// * pdo.{pf}.ploop
+         DICT_POP()),
+    /// @}
+    /// @defgroup Parallel block
+    /// @brief  - n par{ .. | .. | .. }par, each branch an anonymous body in pf
+    /// @{
+    IMMD("par{",
+         ADD_W(new Bran(_par));
+         DICT_PUSH(new Tmp())),
+    IMMD("|",
+         Bran *b = PTGT();
+         Code *x = new Tmp();
+         BRAN(x->pf);                          /// * par{.{x}.| or |.{x}.|
+         b->pf.push(x)),
+    IMMD("}par",
+         Bran *b = PTGT();
+         Code *x = new Tmp();
+         BRAN(x->pf);                          /// * |.{x}.}par
+         b->pf.push(x);
+         DICT_POP()),
     /// @}
     /// @defgrouop Compiler ops
     /// @{
@@ -283,7 +346,14 @@ const Code rom[] {               ///< Forth dictionary
     CODE("@",       U32 i_w = POPI(); PUSH(VAR(i_w))),           /// a -- n
     CODE("!",       U32 i_w = POPI(); VAR(i_w) = POP()),         /// n a -- 
     CODE("+!",      U32 i_w = POPI(); VAR(i_w) += POP()),
-    CODE("?",       U32 i_w = POPI(); dot(DOT, VAR(i_w))),
+    CODE("?",       U32 i_w = POPI(); dot(vm, DOT, VAR(i_w))),
+    CODE("atomic@", U32 i_w = POPI(); PUSH(AVAR(i_w).load())),   /// ( a -- n ) shared between tasks
+    CODE("atomic!", U32 i_w = POPI(); AVAR(i_w).store(POP())),   /// ( n a -- )
+    CODE("atomic+!",U32 i_w = POPI(); _afetch_add(AVAR(i_w), POP())), /// ( n a -- ) no lost updates
+    CODE("cas",     U32 i_w = POPI(); DU n = POP();              /// ( old new a -- t ) store new if cell==old
+         TOS = BOOL(AVAR(i_w).compare_exchange_strong(TOS, n))),
+    CODE("fetch-or",  U32 i_w = POPI(); TOS = _afetch_or(AVAR(i_w), TOS)),  /// ( n a -- n0 ) set bits, n0 before
+    CODE("fetch-and", U32 i_w = POPI(); TOS = _afetch_and(AVAR(i_w), TOS)), /// ( n a -- n0 ) clear bits, n0 before
     CODE(",",       last->pf[0]->q.push(POP())),
     CODE("cells",   { /* for backward compatible */ }),          /// array index, inc by 1
     CODE("allot",   U32 n = POPI();                              /// n --
@@ -302,9 +372,17 @@ const Code rom[] {               ///< Forth dictionary
     /// @}
     CODE("task",                                                /// w -- task_id
          IU w = POPI();                                         ///< dictionary index
-         if (dict[w]->xt) pstr("  ?colon word only\n");
+         if (dict[w]->xt) pstr(vm, "  ?colon word only\n");
          else PUSH(task_create(w))),                            /// create a task starting on pfa
     CODE("rank",    PUSH(vm.id)),                               /// ( -- n ) thread id
+    CODE("yield",   vm.yield()),                                /// ( -- ) let other tasks run
+    CODE("quantum", IU t = POPI(); vm_get(t).quantum = INT(POP())), /// ( n t -- ) words per turn of task t, 0=never preempt
+    CODE("grain",   vm.grain = INT(POP())),                     /// ( n -- ) pdo..ploop chunk size of this task, 0=auto
+    CODE("core",    PUSH(t_core())),                            /// ( -- n ) CPU this task runs on
+    CODE("workers", PUSH(t_workers())),                         /// ( -- n ) number of pool workers
+    CODE("pin",     t_pin(vm, INT(POP()))),                     /// ( n -- ) pin this task onto CPU n, -1=unpin
+    CODE("affinity",t_pool_place(POPI())),                      /// ( p -- ) re-place workers, 1=compact,2=scatter,3=physical
+    CODE("topology",t_topology(vm)),                            /// ( -- ) show CPU topology
     CODE("start",   task_start(POPI())),                        /// ( task_id -- )
     CODE("join",    vm.join(POPI())),                           /// ( task_id -- )
     CODE("lock",    vm.io_lock()),                              /// wait for IO semaphore
@@ -313,6 +391,64 @@ const Code rom[] {               ///< Forth dictionary
     CODE("recv",    vm.recv()),                                 /// ( -- v1 v2 .. vn ) waiting for values passed by sender
     CODE("bcast",   vm.bcast(POPI())),                          /// ( v1 v2 .. vn -- )
     CODE("pull",    IU t = POPI(); vm.pull(t, POPI())),         /// ( tid n -- v1 v2 .. vn )
+    CODE("node",    PUSH(t_node())),                            /// ( -- n ) rank of this process, see -np
+    CODE("nodes",   PUSH(t_nodes())),                           /// ( -- n ) number of processes
+    CODE("gid",     IU k = POPI(); TOS += (DU)((k + 1) * E4_VM_POOL_SZ)), /// ( vid n -- tid ) VM vid on node n, for send
+    CODE("spawn",                                               /// ( w -- f ) start a task as a future
+         IU w = POPI();
+         if (dict[w]->xt) { pstr(vm, "  ?colon word only\n"); return; }
+         IU f = task_spawn(w);
+         if (!f) pstr(vm, "  ?pool exhausted\n");
+         else    PUSH(f)),
+    CODE("await",   IU f = POPI(); vm.await(f, POPI())),        /// ( n f -- v1 v2 .. vn ) wait for future's results
+    CODE("ready?",  PUSH(BOOL(vm_get(POPI()).state==STOP))),    /// ( f -- t ) future completed, non-blocking
+    CODE("channel",                                             /// ( n -- ) create a channel of capacity n
+         DICT_PUSH(new Code(word()));
+         Code *w = ADD_W(new Lit(chan_new(POPI())));
+         w->pf[0]->token = w->token),
+    CODE("chan!",   IU ch = POPI(); chan_put(vm, ch, POP())),   /// ( v ch -- ) send, wait while full
+    CODE("chan@",   TOS = chan_get(vm, UINT(TOS))),             /// ( ch -- v ) receive, wait while empty
+    CODE("chan!?",  IU ch = POPI(); TOS = BOOL(chan_tryput(ch, TOS))), /// ( v ch -- t ) send if not full
+    CODE("chan@?",  DU v;                                       /// ( ch -- v t | f ) receive if not empty
+         if (chan_tryget(UINT(TOS), v)) { TOS = v; PUSH(-1); }
+         else TOS = DU0),
+    CODE("select",                                              /// ( ch1 .. chn n -- v ch ) receive from any
+         IU n = POPI();
+         FV<int> ch;
+         for (IU i = 0; i < n; i++) ch.push(POPI());
+         DU v  = DU0;
+         int x = chan_select(vm, ch.data(), n, v);
+         PUSH(v); PUSH(x)),
+    CODE("pipeline",                                            /// ( xt1 .. xtn n -- ) stages ( v -- v' ) on own VMs
+         const char *nm = word();                               ///< name first, even if full
+         IU n = POPI();
+         FV<IU> w;
+         for (IU i = 0; i < n; i++) w.push(POPI());
+         for (IU i = 0; i < n / 2; i++) { IU t = w[i]; w[i] = w[n-1-i]; w[n-1-i] = t; }
+         int p = pipe_new(w.data(), n);
+         if (p < 0) { pstr(vm, "  ?pool full", CR); return; }
+         DICT_PUSH(new Code(nm));
+         Code *x = ADD_W(new Lit(p));
+         x->pf[0]->token = x->token),
+    CODE("batch",   VM::BATCH = POPI()),                        /// ( n -- ) items per hand-off for new pipelines
+    CODE(">pipe",   IU p = POPI(); pipe_put(vm, p, POP())),     /// ( v p -- ) feed, wait while first stage is behind
+    CODE("pipe>",   DU v;                                       /// ( p -- v t | f ) take a result, f when drained
+         if (pipe_get(vm, UINT(TOS), v)) { TOS = v; PUSH(-1); }
+         else TOS = DU0),
+    CODE("pipe-close", pipe_close(POPI())),                     /// ( p -- ) end of input, hands off last batch
+    CODE(".pipe",   pipe_stat(vm, POPI())),                     /// ( p -- ) per-stage throughput and backlog
+    CODE("after",   U32 ms = POPI(); TOS = t_timer(UINT(TOS), ms, 0)), /// ( xt ms -- h ) run xt once on a pool VM
+    CODE("every",   U32 ms = POPI(); TOS = t_timer(UINT(TOS), ms, ms ? ms : 1)), /// ( xt ms -- h ) run xt periodically
+    CODE("cancel",  t_cancel(POPI())),                          /// ( h -- ) stop a periodic (or pending) timer
+    CODE(".jitter", t_jitter(vm)),                              /// ( -- ) timer lateness histogram, then reset
+#if DO_LOCKSTAT
+    CODE(".locks",  t_locks(vm)),                               /// ( -- ) mutex and cv contention so far
+#endif // DO_LOCKSTAT
+#if DO_TRACE
+    CODE("trace-on",   trc_start()),                            /// ( -- ) record task events
+    CODE("trace-off",  trc_stop()),
+    CODE("trace-dump", trc_dump(vm)),                           /// ( -- ) write them as Chrome trace JSON
+#endif // DO_TRACE
     /// @}
 #endif // DO_MULTITASK    
     /// @defgroup Debug ops
@@ -322,16 +458,30 @@ const Code rom[] {               ///< Forth dictionary
     CODE("'",
          const Code *w = find(word()); if (w) PUSH(w->token)),
     CODE(".s",      ss_dump(vm, true)),                         /// dump parameter stack
-    CODE("words",   words(*vm.base)),                           /// display word lists
+    CODE("words",   words(vm, *vm.base)),                       /// display word lists
     CODE("see",
          const Code *w = find(word());
-         if (w) see(*w, *vm.base);
-         dot(CR)),
-    CODE("dict",    dict_dump(*vm.base)),                       /// display dictionary
+         if (w) see(vm, *w, *vm.base);
+         dot(vm, CR)),
+    CODE("dict",    dict_dump(vm, *vm.base)),                   /// display dictionary
     CODE("dump",                                                /// ' xx 1 dump
-         IU n = POPI(); mem_dump(POPI(), n, *vm.base)), 
+         IU n = POPI(); mem_dump(vm, POPI(), n, *vm.base)), 
     CODE("depth",   PUSH(SS.size())),                           /// data stack depth
     CODE("r",       PUSH(RS.size())),                           /// return stack depth
+    CODE(".mem",      mem_report(vm, false)),                   /// bytes held by each word, largest first
+    CODE(".mem-json", mem_report(vm, true)),                    /// same, and by kind, as JSON
+#if DO_PROFILE
+    CODE("profile-on",    prof_on = true),                      /// count calls and ticks of words
+    CODE("profile-off",   prof_on = false),
+    CODE("profile-reset", prof_reset()),                        /// zero the counters
+    CODE("profile",       prof_dump(vm, *vm.base)),             /// report, costliest first
+#endif // DO_PROFILE
+#if DO_SAMPLE
+    CODE("sample-on",     smp_start(POPI())),                   /// ( hz -- ) sample call chains
+    CODE("sample-off",    smp_stop()),
+    CODE("sample-reset",  smp_reset()),                         /// drop samples taken
+    CODE("samples",       smp_dump(vm)),                        /// folded stacks with counts
+#endif // DO_SAMPLE
     /// @}
     /// @defgroup OS ops
     /// @{
@@ -340,8 +490,16 @@ const Code rom[] {               ///< Forth dictionary
          POP(); U32 i_w = POPI(); load(vm, STR(i_w))),
     CODE("ok",      mem_stat()),                                /// display memory stat
     CODE("clock",   PUSH(millis())),                            /// get system clock in msec
+    CODE("clock-ns",PUSH((U32)clock_ns())),                     /// ( -- n ) steady clock in nsec, low 32 bits
+    CODE("rdtsc",   PUSH((U32)clock_tsc())),                    /// ( -- n ) time stamp counter, low 32 bits
+    CODE("timeit",  U32 n = POPI(); timeit(vm, POPI(), n)),     /// ( xt n -- ) nsec per call, xt leaves stack as is
     CODE("rnd",     PUSH(RND())),                               /// get a random number
-    CODE("ms",      IU i = POPI(); delay(i)),                   /// n -- delay n msec
+    CODE("ms",      IU i = POPI(); vm.sleep(i)),                /// n -- delay n msec
+#if DO_PMC
+    CODE("pmc-start", pmc_start(vm)),                           /// ( -- ) zero and run hardware counters
+    CODE("pmc-stop",  pmc_stop()),                              /// ( -- ) freeze them
+    CODE(".pmc",      pmc_dump(vm)),                            /// ( -- ) cycles, IPC, miss rates
+#endif // DO_PMC
     CODE("forget",
          const Code *w = find(word()); if (!w) return;
          int   t = MAX((int)w->token, (int)find("boot")->token + 1);
@@ -362,28 +520,63 @@ Code::Code(const char *s, bool n) {  ///< new colon word
     desc  = "";
     xt    = w ? w->xt : NULL;
     token = n ? dict.size() : 0;
-    if (n && w) pstr("reDef?");          /// * warn word redefined
+    if (n && w) pstr(vm_get(0), "reDef?"); /// * warn word redefined
 }
 ///
 ///> Forth inner interpreter
 ///
+#if DO_PROFILE
+void _prof_nest(VM &vm, Code &c) {       ///> nest, bracketed by profiler
+    PMark m = prof_in(vm, c.token);
+    try {
+        if (c.xt) c.xt(vm, c);
+        else for (int i=0; i < (int)c.pf.size(); i++) {
+            try         { c.pf[i]->nest(vm); }
+            catch (...) { break; }
+        }
+    }
+    catch (...) { prof_out(vm, c.token, m); throw; }  /// * exit, leave
+    prof_out(vm, c.token, m);
+}
+#endif // DO_PROFILE
 void Code::nest(VM &vm) {
-//    vm.set_state(NEST);                /// * this => lock, major slow down
-    vm.state = NEST;                     /// * racing? No, helgrind says so
+#if DO_MULTITASK
+    vm.state.store(NEST, memory_order_relaxed); /// * atomic, no lock nor fence
+#else  // !DO_MULTITASK
+    vm.state = NEST;
+#endif // DO_MULTITASK
+#if DO_COROUTINE
+    if (--vm.fuel < 0) vm.preempt();     /// * out of fuel, let other tasks run
+#endif // DO_COROUTINE
+#if DO_PROFILE
+    bool prof = prof_on.load(memory_order_relaxed) && token && dict[token]==this;
+    if (xt && prof) { _prof_nest(vm, *this); return; }  /// * dictionary words only
+#endif // DO_PROFILE
     if (xt) { xt(vm, *this); return; }   /// * run primitive word
-
+#if DO_SAMPLE
+    int dp = vm.sdp;                     /// * onto shadow stack, for SIGPROF
+    if (dp < E4_SMP_DEPTH) vm.sp[dp] = this;
+    vm.sdp = dp + 1;                     /// * after sp[dp], seen by handler
+#endif // DO_SAMPLE
+#if DO_PROFILE
+    if (prof) _prof_nest(vm, *this);     /// * colon word, timed, or else
+    else
+#endif // DO_PROFILE
     for (int i=0; i < (int)pf.size(); i++) {
         try         { pf[i]->nest(vm); } /// * execute recursively
         catch (...) { break; }
         // printf("%-3x => RS=%d, SS=%d %s", i, (int)vm.rs.size(), (int)vm.ss.size(), pf[i]->name);
     }
+#if DO_SAMPLE
+    vm.sdp = dp;                         /// * loop catches all, so always popped
+#endif // DO_SAMPLE
 }
 ///====================================================================
 ///
 ///> Primitive Functions
 ///
 void _str(VM &vm, Code &c)  {
-    if (!c.token) pstr(c.name);
+    if (!c.token) pstr(vm, c.name);
     else { PUSH(c.token); PUSH(strlen(c.name)); }
 }
 void _lit(VM &vm, Code &c)  { PUSH(c.q[0]);  }
@@ -426,6 +619,35 @@ void _loop(VM &vm, Code &c) {                  ///> do..loop
     catch (...) {}                             /// handle LEAVE
     RS.pop();                                  /// pop off indicies
 }
+void _ploop(VM &vm, Code &c) {                 ///> pdo..ploop
+#if DO_MULTITASK
+    if (vm.xp != &c) {                         /// * not a forked chunk
+        DU m = RS.pop(), i = RS.pop();         ///< limit, first
+        task_pfor(vm, c, i, m);                /// * split range onto pool VMs
+        return;
+    }
+#endif // DO_MULTITASK
+    _loop(vm, c);                              /// * run chunk serially
+}
+void _par(VM &vm, Code &c) {                   ///> n par{ .. | .. }par
+    int a = INT(POP());                        ///< inputs of each branch
+#if DO_MULTITASK
+    task_par(vm, c, a);                        /// * branches onto pool VMs
+#else  // !DO_MULTITASK
+    FV<DU> ss0 = SS, out;                      ///< stack at par{, results
+    DU     t0  = TOS;
+    int    d   = (int)ss0.size();
+    int    b   = d > a ? d - a : 0;            ///< depth below the inputs
+    for (auto x : c.pf) {                      /// * branches in turn
+        x->nest(vm);
+        for (int i = b + 1; i < (int)SS.size(); i++) out.push(SS[i]);
+        if ((int)SS.size() > b) out.push(TOS);
+        SS = ss0; TOS = t0;                    /// * next branch sees the same
+    }
+    while ((int)SS.size() > b) TOS = SS.pop(); /// * inputs consumed
+    for (DU v : out) PUSH(v);
+#endif // DO_MULTITASK
+}
 void _does(VM &vm, Code &c) {
     bool hit = false;
     for (auto w : dict[c.token]->pf) {
@@ -486,14 +708,17 @@ void forth_init() {
     static bool init = false;         ///< singleton
     if (init) return;
     
-    const int sz = (int)(sizeof(rom))/(sizeof(Code));
-    dict.reserve(sz * 2);             /// * pre-allocate vector
-
     for (const Code &c : rom) {       /// * populate the dictionary
         DICT_PUSH(&c);                /// * ROM => RAM
     }
 
     uvar_init();                      /// * initialize user area
+#if DO_SAMPLE
+    smp_vid = 0;                      /// * main thread runs VM0
+#endif // DO_SAMPLE
+#if DO_PERF
+    perf_map();                       /// * rom is all the machine code
+#endif // DO_PERF
     t_pool_init();                    /// * initialize thread pool
     VM &vm0   = vm_get(0);            ///< main thread
     vm0.state = HOLD;
@@ -517,7 +742,7 @@ int forth_vm(const char *line, void(*hook)(int, const char*)) {
             forth_core(vm, s);        /// * send to Forth core
         }
         catch (exception &e) {
-            pstr(s); pstr("?"); pstr(e.what(), CR);
+            pstr(vm, s); pstr(vm, "?"); pstr(vm, e.what(), CR);
             vm.compile = false;
             scan('\n');               /// * exhaust input line
         }
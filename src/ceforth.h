@@ -7,7 +7,9 @@
 #define __EFORTH_SRC_CEFORTH_H
 #include <iostream>                    /// cin, cout
 #include <iomanip>                     /// setbase
+#include <sstream>                     /// ostringstream
 #include <vector>                      /// vector
+#include <atomic>                      /// dictionary publication
 #include <chrono>
 #include "config.h"
 
@@ -17,10 +19,54 @@ using namespace std;
 #include <mutex>
 #include <condition_variable>
 typedef  thread             THREAD;
+#if DO_LOCKSTAT
+///
+///> mutex and condition variable keeping wait counters
+///
+/// Note: counters change only while the mutex is held, so they need no
+///       atomics, and an uncontended lock costs one try_lock as before
+///
+inline U64 lk_ns() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+struct LStat {                     ///< by the holder of the mutex
+    U64 n    = 0;                  ///< acquired, or waits on a cv
+    U64 busy = 0;                  ///< had to block
+    U64 ns   = 0, max = 0;         ///< blocked time, total and worst
+    U64 spur = 0;                  ///< cv woken with nothing to do
+    void add(U64 t0) { U64 d = lk_ns() - t0; busy++; ns += d; if (d > max) max = d; }
+};
+struct LMutex : mutex {
+    LStat st;
+    void lock() {
+        if (!try_lock()) { U64 t0 = lk_ns(); mutex::lock(); st.add(t0); }
+        st.n++;
+    }
+};
+struct LCond : condition_variable_any {
+    LStat st;
+    template<typename L, typename P>
+    void wait(L &lk, P p) {        ///< the only form WAIT uses
+        st.n++;
+        if (p()) return;
+        U64 t0 = lk_ns();
+        while (true) {
+            condition_variable_any::wait(lk);
+            if (p()) break;
+            st.spur++;
+        }
+        st.add(t0);
+    }
+};
+typedef  LMutex             MUTEX;
+typedef  LCond              COND_VAR;
+#else  // !DO_LOCKSTAT
 typedef  mutex              MUTEX;
 typedef  condition_variable COND_VAR;
-#define  GUARD(m)           lock_guard<mutex>  _grd_(m)
-#define  XLOCK(m)           unique_lock<mutex> _xlck_(m)   /** exclusive lock     */
+#endif // DO_LOCKSTAT
+#define  GUARD(m)           lock_guard<MUTEX>  _grd_(m)
+#define  XLOCK(m)           unique_lock<MUTEX> _xlck_(m)   /** exclusive lock     */
 #define  WAIT(cv,g)         (cv).wait(_xlck_, g)           /** wait for condition */
 #define  NOTIFY(cv)         (cv).notify_one()              /** wake up one task   */
 #define  NOTIFY_ALL(cv)     (cv).notify_all();
@@ -31,6 +77,9 @@ typedef  condition_variable COND_VAR;
 #ifdef _POSIX_VERSION
 #include <sched.h>                 /// CPU affinity
 #endif // _POSIX_VERSION
+#if DO_COROUTINE
+#include <ucontext.h>              /// green-thread context switch
+#endif // DO_COROUTINE
 #endif // DO_MULTITASK
 
 template<typename T>
@@ -53,11 +102,65 @@ struct FV : public vector<T> {      ///< our super-vector class
 #endif // CC_DEBUG
     }
 };
+///
+///> stable chunked storage for the dictionary
+///
+/// Note: one writer (the compiler on VM0) and many readers (tasks).
+///       Entries live in fixed blocks that never move, and the size is
+///       published after the entry is stored, so tasks can index the
+///       dictionary without a lock while new words are being defined.
+///       Only the index is stable: pf and q of a word are vectors that
+///       `,`, `allot` and `variable` can reallocate, and forget lets new
+///       words reuse slots.
+///       Max 64K entries, same as the 16-bit word index used by VAR().
+///
+template<typename T>
+struct FD {                         ///< our dictionary class
+    static const int BSZ  = 256;    ///< entries per block
+    static const int NBLK = 256;    ///< max number of blocks
+    T           *blk[NBLK] = {};    ///< blocks, allocated on demand
+    atomic<int> sz { 0 };           ///< published size
+
+    struct iter {                   ///< forward iterator for range-for
+        FD  *d; int i;
+        T    &operator*()                { return (*d)[i]; }
+        iter &operator++()               { ++i; return *this; }
+        bool operator!=(const iter &o) const { return i != o.i; }
+    };
+    ~FD() { for (T *b : blk) delete[] b; }  ///< entries are not owned
+    int  size()   { return sz.load(memory_order_acquire); }
+    iter begin()  { return { this, 0 }; }
+    iter end()    { return { this, size() }; }
+    void clear()  { sz.store(0, memory_order_release); }
+    void push(T n) {                ///< single writer only
+        int i = sz.load(memory_order_relaxed);
+        if (i >= BSZ * NBLK) throw length_error("dictionary full");
+        T *&b = blk[i / BSZ];
+        if (!b) b = new T[BSZ];
+        b[i % BSZ] = n;
+        sz.store(i + 1, memory_order_release);   /// * publish new entry
+    }
+    T    pop() {
+        int i = sz.load(memory_order_relaxed) - 1;
+        T   n = blk[i / BSZ][i % BSZ];
+        sz.store(i, memory_order_release);       /// * entry is not freed
+        return n;
+    }
+    T    &operator[](int i) {
+        int n = size();
+        if (i < 0) i += n;
+#if CC_DEBUG
+        if (i < 0 || i >= n) throw out_of_range("dict");
+#endif // CC_DEBUG
+        return blk[i / BSZ][i % BSZ];
+    }
+};
 ///====================================================================
 ///
 ///> VM context (single task)
 ///
-typedef enum { STOP=0, HOLD, QUERY, NEST } vm_state;
+typedef enum { STOP=0, HOLD, QUERY, NEST, MSG, RECV } vm_state; ///< RECV: in recv, MSG: message being delivered
+struct Code;                       ///< Code class forward declaration
 struct ALIGNAS VM {
     FV<DU>   ss;                   ///< data stack
     FV<DU>   rs;                   ///< return stack
@@ -65,14 +168,40 @@ struct ALIGNAS VM {
     DU       tos     = -DU1;       ///< cached top of stack
     IU       id      = 0;          ///< vm id
     IU       wp      = 0;          ///< word pointer
+    atomic<Code*> xp { NULL };     ///< task body, dict[wp] if NULL
     
     U8       *base   = 0;          ///< numeric radix (a pointer)
+#if DO_MULTITASK
+    atomic<vm_state> state { STOP }; ///< VM status, changed lock-free
+    atomic<int>      nwait { 0 };    ///< # of VMs waiting on this VM's state
+#else  // !DO_MULTITASK
     vm_state state   = STOP;       ///< VM status
+#endif // DO_MULTITASK
     bool     compile = false;      ///< compiler flag
+#if DO_SAMPLE
+    Code * volatile sp[E4_SMP_DEPTH]; ///< shadow stack, colon words running
+    volatile int    sdp  = 0;      ///< shadow stack depth
+#endif // DO_SAMPLE
 
-    string   pad;
+    string        pad;             ///< string scratch pad
+    ostringstream fout;            ///< output buffer, flushed by line
 #if DO_MULTITASK
+#if DO_COROUTINE
+    ucontext_t *ctx    = NULL;     ///< green-thread context
+    ucontext_t *host   = NULL;     ///< worker context to switch back to
+    char       *stk    = NULL;     ///< green-thread stack
+    bool       live    = false;    ///< running on a green thread
+    bool       park    = false;    ///< suspend requested (off the queue)
+    bool       parked  = false;    ///< suspended, waiting to be woken
+    bool       wake    = false;    ///< woken before park committed
+    int        wait_id = -1;       ///< VM id this VM is waiting on
+#endif // DO_COROUTINE
+    S32        fuel    = E4_QUANTUM; ///< words left in this turn
+    S32        quantum = E4_QUANTUM; ///< words per turn, 0=run to completion
+    S32        grain   = 0;        ///< pdo..ploop chunk size, 0=auto
+    int        cpu     = -1;       ///< CPU the task is pinned to, -1=any
     static int      NCORE;         ///< number of hardware cores
+    static int      BATCH;         ///< items per pipeline hand-off
     
     static bool     io_busy;       ///< IO locking control
     static MUTEX    io;            ///< mutex for io access
@@ -83,10 +212,13 @@ struct ALIGNAS VM {
     ///
     /// task life cycle methods
     ///
-    void set_state(vm_state st);   ///< set VM state (synchronized)
+    void set_state(vm_state st);   ///< set VM state, wake its waiters
     void reset(IU w, vm_state st); ///< reset a VM user variables
     void join(int tid);            ///< wait for the given task to end
     void stop();                   ///< stop VM
+    void yield();                  ///< give worker to other tasks
+    void preempt();                ///< quantum used up, refuel and yield
+    void sleep(U32 ms);            ///< suspend VM for ms milliseconds
     ///
     /// messaging interface
     ///
@@ -94,6 +226,7 @@ struct ALIGNAS VM {
     void recv();                   ///< receive data from any sending VM's stack (blocking, wait for sender's message)
     void bcast(int n);             ///< broadcast to all receivers
     void pull(int tid, int n);     ///< pull n items from the stack of a stopped task
+    void await(int tid, int n);    ///< take n results of a spawned task (blocking)
     ///
     /// IO interface
     ///
@@ -102,12 +235,12 @@ struct ALIGNAS VM {
 #else  // DO_MULTITASK
     
     void set_state(vm_state st) { state = st; }
+    void sleep(U32 ms)          { delay(ms); }
 #endif // DO_MULTITASK
 };
 ///
 ///> data structure for dictionary entry
 ///
-struct Code;                       ///< Code class forward declaration
 typedef void (*XT)(VM &vm, Code&); ///< function pointer
 
 struct Code  {                     ///> Colon words
@@ -160,6 +293,8 @@ void   _if(VM &vm,  Code &c);        ///< if..then, if..else..then
 void   _begin(VM &vm, Code &c);      ///< ..until, ..again, ..while..repeat
 void   _for(VM &vm, Code &c);        ///< for..next, for..aft..then..next
 void   _loop(VM &vm, Code &c);       ///< do..loop
+void   _ploop(VM &vm, Code &c);      ///< pdo..ploop
+void   _par(VM &vm, Code &c);        ///< par{ .. | .. }par
 void   _does(VM &vm, Code &c);       ///< does>
 ///
 ///> polymorphic constructors
@@ -179,9 +314,9 @@ struct Bran : Code {
     FV<Code*>  p2;                   ///< parameter field - then..next
     Bran(XT fp) : Code(fp) {
         const char *nm[] = {
-            "if", "begin", "\t", "for", "\t", "do", "does>"
+            "if", "begin", "\t", "for", "\t", "do", "pdo", "par{", "does>"
         };
-        XT xt[] = { _if, _begin, _tor, _for, _tor2, _loop, _does };
+        XT xt[] = { _if, _begin, _tor, _for, _tor2, _loop, _ploop, _par, _does };
     
         for (int i=0; i < (int)(sizeof(nm)/sizeof(const char*)); i++) {
             if ((uintptr_t)xt[i]==(uintptr_t)fp) name = nm[i];
@@ -197,10 +332,47 @@ VM&  vm_get(int id=0);                    ///< get a VM with given id
 void uvar_init();                         ///< initialize user area
 
 #if DO_MULTITASK
+typedef enum { PIN_NONE=0, PIN_COMPACT, PIN_SCATTER, PIN_PHYSICAL } pin_policy;
 void t_pool_init();
 void t_pool_stop();
+void t_pool_place(int policy);            ///< re-pin workers by placement policy
+void t_pin(VM &vm, int cpu);              ///< pin a task onto a CPU, -1=unpin
+int  t_core();                            ///< CPU calling thread is running on
+int  t_workers();                         ///< number of pool workers
+void t_topology(VM &vm);                  ///< show CPU topology
 int  task_create(IU w);                   ///< create a VM starting on dict[w]
 void task_start(int tid);                 ///< start a thread with given task/VM id
+int  task_spawn(IU w);                    ///< start dict[w] as a future, 0=pool full
+int  chan_new(int n);                     ///< create a channel with capacity n
+void chan_put(VM &vm, int ch, DU v);      ///< send, wait while channel full
+DU   chan_get(VM &vm, int ch);            ///< receive, wait while channel empty
+bool chan_tryput(int ch, DU v);           ///< send if not full
+bool chan_tryget(int ch, DU &v);          ///< receive if not empty
+int  chan_select(VM &vm, int *ch, int n, DU &v); ///< receive from any of n channels
+int  pipe_new(IU *w, int n);               ///< start n stages as a pipeline, -1=pool full
+void pipe_put(VM &vm, int p, DU v);       ///< feed an item into the pipeline
+bool pipe_get(VM &vm, int p, DU &v);      ///< take an item out, false when drained
+void pipe_close(int p);                   ///< end of input
+void pipe_stat(VM &vm, int p);            ///< show per-stage counters
+int  t_timer(IU w, U32 ms, U32 period);   ///< run dict[w] in ms (then every period ms)
+void t_cancel(int h);                     ///< remove a pending or periodic timer
+void t_jitter(VM &vm);                    ///< show timer wakeup lateness histogram
+#if DO_LOCKSTAT
+void t_locks(VM &vm);                     ///< show mutex and cv wait counters
+#endif // DO_LOCKSTAT
+void task_pfor(VM &vm, Code &c, DU i, DU m); ///< run pdo..ploop chunks on pool VMs
+void task_par(VM &vm, Code &c, int a);    ///< run par{ .. }par branches on pool VMs
+int  t_node();                            ///< rank of this process, 0 if alone
+int  t_nodes();                           ///< # of processes passing messages
+#if DO_TRACE
+typedef enum {                            ///< trace events, see TRC_NAME
+    TRC_RUN=0, TRC_IDLE, TRC_CREATE, TRC_START, TRC_FINISH,
+    TRC_SEND, TRC_RECV, TRC_PULL, TRC_LOCK
+} trc_kind;
+void trc_start();                         ///< record task events
+void trc_stop();
+void trc_dump(VM &vm);                    ///< write Chrome trace-event JSON
+#endif // DO_TRACE
 #else  // !DO_MULTITASK
 #define t_pool_init()  {}
 #define t_pool_stop()  {}
@@ -223,6 +395,7 @@ typedef enum { RDX=0, CR, DOT, UDOT, EMIT, SPCS } io_op;
 
 void fin_setup(const char *line);
 void fout_setup(void (*hook)(int, const char*));
+void fout_flush(ostringstream &fout);     ///< send buffered output to sink
 
 const Code *find(const char *s);          ///< dictionary scanner forward declare
 const char *scan(char c);                 ///< scan input stream for a given char
@@ -230,17 +403,57 @@ const char *word(char delim=0);           ///< read next idiom from input stream
 int  fetch(string &idiom);                ///< read input stream into string
 char key();                               ///< read key from console
 void load(VM &vm, const char *fn);        ///< load external Forth script
-void spaces(int n);                       ///< show spaces
-void dot(io_op op, DU v=DU0);             ///< print literals
-void dotr(int w, DU v, int b, bool u=false); ///< print fixed width literals
-void pstr(const char *str, io_op op=SPCS);///< print string
+void spaces(VM &vm, int n);               ///< show spaces
+void dot(VM &vm, io_op op, DU v=DU0);     ///< print literals
+void dotr(VM &vm, int w, DU v, int b, bool u=false); ///< print fixed width literals
+void pstr(VM &vm, const char *str, io_op op=SPCS);   ///< print string
+string json_str(const char *s);           ///< JSON string literal of s
 ///
 ///> Debug functions
 ///
 void ss_dump(VM &vm, bool forced=false);  ///< show data stack content
-void see(const Code &c, int base);        ///< disassemble user defined word
-void words(int base);                     ///< list dictionary words
-void dict_dump(int base);                 ///< dump dictionary
-void mem_dump(IU w0, IU w1, int base);    ///< dump memory for a given wordrm addr...addr+sz
+void see(VM &vm, const Code &c, int base);///< disassemble user defined word
+void words(VM &vm, int base);             ///< list dictionary words
+void dict_dump(VM &vm, int base);         ///< dump dictionary
+void mem_dump(VM &vm, IU w0, IU w1, int base); ///< dump memory for a given wordrm addr...addr+sz
 void mem_stat();                          ///< display memory statistics
+void mem_report(VM &vm, bool json);       ///< bytes held per word and per kind
+U64  clock_ns();                          ///< steady clock in nsec
+U64  clock_tsc();                         ///< time stamp counter, nsec if none
+void timeit(VM &vm, IU w, int n);         ///< nsec per call of dict[w], percentiles
+///
+///> Profiler - per dictionary word call counts and ticks
+///
+#if DO_PROFILE
+struct PMark { U64 t0, kid; };            ///< entry tick, caller's child ticks
+extern atomic<bool> prof_on;              ///< checked once per nest
+PMark prof_in(VM &vm, IU w);              ///< enter dict[w]
+void  prof_out(VM &vm, IU w, PMark &m);   ///< leave dict[w]
+void  prof_reset();                       ///< zero all counters
+void  prof_dump(VM &vm, int base);        ///< report, sorted by exclusive ticks
+#endif // DO_PROFILE
+///
+///> Sampler - SIGPROF samples of Forth call chains
+///
+#if DO_SAMPLE
+extern thread_local int smp_vid;          ///< VM run by this thread, -1=none
+void smp_start(int hz);                   ///< sample hz times per CPU second
+void smp_stop();
+void smp_reset();
+void smp_dump(VM &vm);                    ///< folded stacks, for flamegraph.pl
+#endif // DO_SAMPLE
+///
+///> perf map and jitdump - Forth names of primitives for Linux perf
+///
+#if DO_PERF
+void perf_map();                          ///< name primitives for Linux perf
+#endif // DO_PERF
+///
+///> Hardware counters - cycles, instructions, misses of this thread
+///
+#if DO_PMC
+void pmc_start(VM &vm);                   ///< zero and enable counters
+void pmc_stop();                          ///< disable and read them
+void pmc_dump(VM &vm);                    ///< counts, IPC and miss rates
+#endif // DO_PMC
 #endif  // __EFORTH_SRC_CEFORTH_H
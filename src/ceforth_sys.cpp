@@ -8,20 +8,22 @@
 #include "ceforth.h"
 using namespace std;
 
-extern FV<Code*> dict;
+extern FD<Code*> dict;
 ///
 ///> I/O streaming interface
 ///
 istringstream   fin;                   ///< forth_in
-ostringstream   fout;                  ///< forth_out
 void (*fout_cb)(int, const char*);     ///< forth output callback functi
 int load_dp = 0;                       ///< load depth control
+#if DO_MULTITASK
+MUTEX           sink;                  ///< serialize flushes to fout_cb
+#endif // DO_MULTITASK
 ///====================================================================
 ///
 ///> IO functions
 ///
 void fin_setup(const char *line) {
-    fout.str("");                      /// * clean output buffer
+    vm_get(0).fout.str("");            /// * clean output buffer
     fin.clear();                       /// * clear input stream error bit if any
     fin.str(line);                     /// * reload user command into input stream
 }
@@ -29,6 +31,21 @@ void fout_setup(void (*hook)(int, const char*)) {
     auto cb = [](int, const char *rst) { printf("%s", rst); };
     fout_cb = hook ? hook : cb;        ///< serial output hook up
 }
+///
+///> flush a VM's output buffer to the sink as one piece
+///
+/// Note: each VM buffers its own output until cr (or prompt), so
+///       lines from parallel tasks never interleave without lock/unlock
+///
+void fout_flush(ostringstream &fout) {
+    string s = fout.str();
+    fout.str("");
+    if (s.empty()) return;
+#if DO_MULTITASK
+    GUARD(sink);
+#endif // DO_MULTITASK
+    fout_cb((int)s.length(), s.c_str());
+}
 const char *scan(char c) {
     static string s;                   ///< temp str, static prevents reclaim
     getline(fin, s, c);                ///< scan fin for char c
@@ -40,7 +57,7 @@ const char *word(char delim) {         ///> read next idiom form input stream
 
     if (s.size()) return s.c_str();    ///< return a new copy of string
 
-    pstr(" ?str");
+    pstr(vm_get(0), " ?str");          /// * fin belongs to VM0
     return NULL;
 }
 int fetch(string &idiom) {             ///> read an idiom from input stream
@@ -51,6 +68,7 @@ void load(VM &vm, const char *fn) {    ///> include script from stream
     load_dp++;                         /// * increment depth counter
     void (*cb)(int, const char*) = fout_cb;  ///< keep output function
     string in; getline(fin, in);             ///< keep input buffers
+    ostringstream &fout = vm.fout;
     fout << ENDL;                      /// * flush output
 
     vm.rs.push(vm.state);              /// * save context
@@ -62,32 +80,43 @@ void load(VM &vm, const char *fn) {    ///> include script from stream
     fin.clear(); fin.str(in);          /// * restore input
     --load_dp;                         /// * decrement depth counter
 }
-void spaces(int n) { for (int i = 0; i < n; i++) fout << " "; }
-void dot(io_op op, DU v) {
+void spaces(VM &vm, int n) { for (int i = 0; i < n; i++) vm.fout << " "; }
+void dot(VM &vm, io_op op, DU v) {
+    ostringstream &fout = vm.fout;
     switch (op) {
     case RDX:   fout << setbase(UINT(v));               break;
     case CR:    fout << ENDL;                           break;
     case DOT:   fout << v << " ";                       break;
     case UDOT:  fout << static_cast<U32>(v) << " ";     break;
     case EMIT:  { char b = (char)UINT(v); fout << b; }  break;
-    case SPCS:  spaces(UINT(v));                        break;
+    case SPCS:  spaces(vm, UINT(v));                    break;
     default:    fout << "unknown io_op=" << op << ENDL; break;
     }
 }
-void dotr(int w, DU v, int b, bool u) {
-    fout << setbase(b) << setw(w)
-         << (u ? static_cast<U32>(v) : v);
+void dotr(VM &vm, int w, DU v, int b, bool u) {
+    vm.fout << setbase(b) << setw(w)
+            << (u ? static_cast<U32>(v) : v);
 }
-void pstr(const char *str, io_op op) {
+void pstr(VM &vm, const char *str, io_op op) {
+    ostringstream &fout = vm.fout;
     fout << str;
     if (op==CR) { fout << ENDL; }
 }
+string json_str(const char *s) {                 ///> quoted, escaped
+    string r = "\"";
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') r += '\\';
+        if ((U8)*s >= 0x20) r += *s;
+    }
+    return r + "\"";
+}
 ///====================================================================
 ///
 ///> Debug functions
 ///
 void ss_dump(VM &vm, bool forced) {       ///> display data stack and ok promt
     if (load_dp) return;                  /// * skip when including file
+    ostringstream &fout = vm.fout;
 #if DO_WASM    
     if (!forced) { fout << "ok" << ENDL; return; }
 #endif // DO_WASM
@@ -115,21 +144,27 @@ void ss_dump(VM &vm, bool forced) {       ///> display data stack and ok promt
     TOS = SS.pop();
     fout << "ok " << FLUSH;
 }
-void _see(const Code &c, int dp) {       ///> disassemble a colon word
+void _see(ostringstream &fout, const Code &c, int dp) { ///> disassemble a colon word
     if (dp > 2) return;
-    auto pp = [](const string &s, const FV<Code*> &pf, int dp) { ///> recursive dump with indent
+    auto pp = [&fout](const string &s, const FV<Code*> &pf, int dp) { ///> recursive dump with indent
         int i = dp;
         if (dp && s != "\t") { fout << ENDL; }   ///> newline control
         while (i--) { fout << "  "; } fout << s; ///> indentation control
-        for (auto w : pf) _see(*w, dp + 1);
+        for (auto w : pf) _see(fout, *w, dp + 1);
     };
-    auto pq = [](const FV<DU> &q) {
+    auto pq = [&fout](const FV<DU> &q) {
         for (DU i : q) fout << i << (q.size() > 1 ? " " : "");
     };
     const FV<Code*> nil = {};
     string sn(c.name);
     
     if (c.is_str) sn = (c.token ? "s\" " : ".\" ") + sn + "\"";
+    if (sn=="par{") {                      ///> branches split by |
+        int i = 0;
+        for (auto b : c.pf) pp(i++ ? "|" : sn, b->pf, dp);
+        pp("}par", nil, dp);
+        return;
+    }
     pp(sn, c.pf, dp);
     
     if (sn=="if")    {
@@ -156,15 +191,20 @@ void _see(const Code &c, int dp) {       ///> disassemble a colon word
     else if (sn=="do") {
         pp("loop", nil, dp);
     }
+    else if (sn=="pdo") {
+        pp("ploop", nil, dp);
+    }
     else pq(c.q);
 }
-void see(const Code &c, int base) {
+void see(VM &vm, const Code &c, int base) {
+    ostringstream &fout = vm.fout;
     if (c.xt) fout << "  ->{ " << c.desc << "; }";
     else {
-        fout << ": "; _see(c, 0); fout << " ;";
+        fout << ": "; _see(fout, c, 0); fout << " ;";
     }
 }
-void words(int base) {                    ///> display word list
+void words(VM &vm, int base) {            ///> display word list
+    ostringstream &fout = vm.fout;
     const int WIDTH = 60;
     int x = 0;
     fout << setbase(16) << setfill('0');
@@ -187,7 +227,8 @@ void words(int base) {                    ///> display word list
 ///
 ///> System statistics - for heap, stack, external memory debugging
 ///
-void dict_dump(int base) {
+void dict_dump(VM &vm, int base) {
+    ostringstream &fout = vm.fout;
     fout << setbase(16) << ENDL;
     int i=0;
     for (auto c : dict) {
@@ -199,8 +240,8 @@ void dict_dump(int base) {
     }
     fout << setbase(base) << setfill(' ') << setw(-1);
 }
-void _dump(Code *c, int dp) {
-    auto pp = [](const char *s, FV<Code*> &pf, int dp) {
+void _dump(ostringstream &fout, Code *c, int dp) {
+    auto pp = [&fout](const char *s, FV<Code*> &pf, int dp) {
         if (pf.size()==0) return;
         int i = dp;
         if (dp) { fout << ENDL; }                ///> newline control
@@ -218,7 +259,7 @@ void _dump(Code *c, int dp) {
             }
             else fout << (w->name[0]=='\t' ? "\\t" : w->name);
             fout << " ";
-            _dump(w, dp + 1);
+            _dump(fout, w, dp + 1);
         }
         fout << "} ";
     };
@@ -228,15 +269,710 @@ void _dump(Code *c, int dp) {
         pp("p2", ((Bran*)c)->p2, dp);
     }
 }
-void mem_dump(IU w0, IU n, int base) {           ///> ' xx 1 dump
+void mem_dump(VM &vm, IU w0, IU n, int base) {   ///> ' xx 1 dump
+    ostringstream &fout = vm.fout;
     fout << setbase(16) << setfill('0');
-    auto cx = dict.begin() + w0 + n;
-    for (auto c = dict.begin() + w0; c != cx; c++) {
-        fout << setw(4) << (int)(c - dict.begin()) << ": ";
-        if ((*c)->xt) fout << "built-in";        ///< primitives
-        else          _dump(*c, 1);              ///< colon wordsa
+    for (int i = w0; i < w0 + n; i++) {
+        Code *c = dict[i];
+        fout << setw(4) << i << ": ";
+        if (c->xt) fout << "built-in";           ///< primitives
+        else       _dump(fout, c, 1);            ///< colon wordsa
         fout << ENDL;
     }
     fout << setbase(base) << setfill(' ');
 }
+///
+///> memory accounting - bytes held by each word, by kind of object
+///
+/// Note: a word owns the nodes in its pf (and p1, p2) that are not words
+///       themselves, i.e. literals, variables, strings, branches and
+///       temporaries, counted once each. Columns are
+///         obj   - Code (or Bran) objects, rom primitives are static
+///         pf, q - used part of the parameter vectors
+///         str   - names of colon words and string literals
+///         slack - vector capacity not used
+///         heap  - allocator overhead, estimated as 64-bit glibc chunks
+///                 (8-byte header, 16-byte aligned, 32 bytes min)
+///
+#include <algorithm>                   /// sort
+#include <unordered_set>
+typedef enum { M_COLON=0, M_LIT, M_VAR, M_STR, M_BRAN, M_TMP, M_NK } mem_kind;
+const char *MEM_KIND[] = { "colon", "lit", "var", "str", "bran", "tmp" };
+struct MemRow {
+    IU  w;                                       ///< dict index
+    U32 node;                                    ///< nodes owned
+    U64 obj, pf, q, str, slack, heap;
+    U64 total() const { return obj + pf + q + str + slack + heap; }
+};
+struct MemUse {
+    vector<MemRow>             row;              ///< words holding memory
+    U32                        kn[M_NK];         ///< nodes by kind
+    U64                        kb[M_NK];         ///< object bytes by kind
+    MemRow                     sum;              ///< all words
+    U64                        rom, idx, vm;     ///< system
+    unordered_set<const void*> seen;             ///< counted already
+};
+U64 _chunk(U64 n) {                              ///> heap chunk for n bytes
+    return max((U64)32, ALIGN16(n + 8));
+}
+template<typename T>
+void _mem_vec(MemRow &r, U64 &used, FV<T> &v) {
+    if (!v.capacity()) return;
+    U64 n = v.capacity() * sizeof(T);
+    used    += v.size() * sizeof(T);
+    r.slack += n - v.size() * sizeof(T);
+    r.heap  += _chunk(n) - n;
+}
+void _mem_str(MemRow &r, const char *s) {        ///> from new string(s)
+    U64 n = strlen(s) + 1;
+    U64 h = n > 16 ? n : 0;                      ///< past SSO buffer
+    r.str  += sizeof(string) + h;
+    r.heap += _chunk(sizeof(string)) - sizeof(string) + (h ? _chunk(h) - h : 0);
+}
+bool _mem_word(Code *c) {                        ///> a dictionary word, not owned
+    int t = c->token;
+    return !c->is_str && t && t < dict.size() && dict[t]==c;
+}
+void _mem_walk(MemUse &m, MemRow &r, Code *c, bool top=false) {
+    if (!m.seen.insert(c).second) return;
+    int k = top          ? M_COLON
+          : c->is_str    ? M_STR  : c->is_bran ? M_BRAN
+          : c->xt==_lit  ? M_LIT  : c->xt==_var ? M_VAR : M_TMP;
+    if (!(top && c->xt)) {                       /// * rom primitives are static
+        U64 sz = c->is_bran ? sizeof(Bran) : sizeof(Code);
+        r.node++; r.obj += sz; r.heap += _chunk(sz) - sz;
+        m.kn[k]++; m.kb[k] += sz;
+    }
+    if ((k==M_STR || (top && !c->xt)) && m.seen.insert(c->name).second)
+        _mem_str(r, c->name);                    /// * a redefinition shares it
+    auto sub = [&m, &r](FV<Code*> &pf) {
+        for (auto w : pf) if (!_mem_word(w)) _mem_walk(m, r, w);
+    };
+    _mem_vec(r, r.pf, c->pf);
+    _mem_vec(r, r.q,  c->q);
+    sub(c->pf);
+    if (c->is_bran) {
+        Bran *b = (Bran*)c;
+        _mem_vec(r, r.pf, b->p1);
+        _mem_vec(r, r.pf, b->p2);
+        sub(b->p1);
+        sub(b->p2);
+    }
+}
+void _mem_use(MemUse &m) {
+    m = {};
+    int nw = dict.size();
+    for (int i = 0; i < nw; i++) {
+        Code  *c = dict[i];
+        MemRow r = { (IU)i, 0, 0, 0, 0, 0, 0, 0 };
+        if (c->xt) m.rom += sizeof(Code);
+        _mem_walk(m, r, c, true);
+        if (!r.total()) continue;
+        m.row.push_back(r);
+        m.sum.node += r.node; m.sum.obj += r.obj; m.sum.pf    += r.pf;    m.sum.q    += r.q;
+        m.sum.str  += r.str;  m.sum.heap += r.heap; m.sum.slack += r.slack;
+    }
+    sort(m.row.begin(), m.row.end(),
+         [](const MemRow &a, const MemRow &b) { return a.total() > b.total(); });
+    for (auto b : dict.blk) if (b) m.idx += sizeof(Code*) * FD<Code*>::BSZ;
+#if DO_MULTITASK
+    const int nvm = E4_VM_POOL_SZ;
+#else  // !DO_MULTITASK
+    const int nvm = 1;
+#endif // DO_MULTITASK
+    for (int i = 0; i < nvm; i++) {
+        VM &vm = vm_get(i);
+        m.vm += sizeof(VM) + (vm.ss.capacity() + vm.rs.capacity()) * sizeof(DU);
+#if DO_COROUTINE
+        if (vm.stk) m.vm += E4_VM_STACK_SZ;      /// * green-thread stack
+#endif // DO_COROUTINE
+    }
+}
+void mem_report(VM &vm, bool json) {             ///> per word and per kind
+    ostringstream &fout = vm.fout;
+    MemUse m;
+    _mem_use(m);
+    fout << setbase(10) << setfill(' ');
+    if (json) {
+        auto cols = [&fout](const MemRow &r) {
+            fout << "\"nodes\":" << r.node << ",\"obj\":" << r.obj
+                 << ",\"pf\":"   << r.pf   << ",\"q\":"   << r.q
+                 << ",\"str\":"  << r.str  << ",\"slack\":" << r.slack
+                 << ",\"heap\":" << r.heap << ",\"total\":" << r.total();
+        };
+        fout << "{\"unit\":\"bytes\",\"words\":[";
+        for (size_t i = 0; i < m.row.size(); i++) {
+            MemRow &r = m.row[i];
+            fout << (i ? "," : "") << "\n{\"token\":" << r.w
+                 << ",\"name\":" << json_str(dict[r.w]->name) << ',';
+            cols(r);
+            fout << '}';
+        }
+        fout << "],\n\"kinds\":{";
+        for (int k = 0; k < M_NK; k++) {
+            fout << (k ? "," : "") << '"' << MEM_KIND[k] << "\":{\"count\":"
+                 << m.kn[k] << ",\"obj\":" << m.kb[k] << '}';
+        }
+        fout << "},\n\"words_total\":{";
+        cols(m.sum);
+        fout << "},\n\"system\":{\"rom\":" << m.rom << ",\"dict\":" << m.idx
+             << ",\"vm\":" << m.vm << "}}" << ENDL;
+    }
+    else {
+        auto cols = [&fout](const MemRow &r) {
+            fout << setw(6) << r.node << setw(8) << r.obj << setw(8) << r.pf
+                 << setw(8) << r.q    << setw(8) << r.str << setw(8) << r.slack
+                 << setw(8) << r.heap << setw(9) << r.total();
+        };
+        fout << ENDL;
+        fout << "  nodes     obj      pf       q     str   slack    heap    total  word" << ENDL;
+        for (auto &r : m.row) {
+            cols(r);
+            fout << "  " << dict[r.w]->name << ENDL;
+        }
+        cols(m.sum);
+        fout << "  (" << m.row.size() << " words)" << ENDL;
+        fout << "  ";
+        for (int k = 0; k < M_NK; k++) fout << MEM_KIND[k] << "=" << m.kn[k] << " ";
+        fout << "nodes" << ENDL;
+        fout << "  rom=" << m.rom << " dict=" << m.idx
+             << " vm=" << m.vm << " bytes outside words" << ENDL;
+    }
+    fout << setbase(*vm.base);
+}
+///====================================================================
+///
+///> Timing - nsec clock, time stamp counter, and timeit
+///
+/// Note: timeit runs xt n times, as up to 1000 samples of n/1000 calls
+///       (the remainder spread one each over the first samples), after
+///       one call that must keep the stack depth. A sample is its batch
+///       time per call less that of the same loop calling an empty word
+///       (median), so clock reads and loop overhead are taken out.
+///       Percentiles are over the samples
+///
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>                 /// __rdtsc
+#endif // x86
+#include <algorithm>                   /// sort
+U64 clock_ns() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+U64 clock_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    U64 v;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(v));  /// * virtual counter
+    return v;
+#else  // no counter
+    return clock_ns();
+#endif // x86
+}
+Code _noop([](VM &vm, Code &c) {});              ///< loop overhead reference
+
+U64 _batch(VM &vm, Code &c, int k) {             ///> nsec of k calls
+    U64 t0 = clock_ns();
+    for (int i = 0; i < k; i++) c.nest(vm);
+    return clock_ns() - t0;
+}
+void timeit(VM &vm, IU w, int n) {
+    ostringstream &fout = vm.fout;
+    if (n < 1) n = 1;
+    FV<DU> ss0 = vm.ss;                          ///< stack before the first call
+    DU     t0  = vm.tos;
+    dict[w]->nest(vm);                           /// * warm up, and check depth
+    bool bad = vm.ss.size() != ss0.size();
+    vm.ss = ss0; vm.tos = t0;                    /// * each run sees the same stack
+    if (bad) {
+        fout << "  ?" << dict[w]->name << " changes stack depth" << ENDL;
+        return;
+    }
+    int ns = min(n, 1000);                       ///< samples
+    int k  = n / ns, r = n % ns;                 ///< calls per sample, first r one more
+    vector<double> t(ns), o(ns);
+    for (int i = 0; i < ns; i++) {
+        int m = k + (i < r);
+        t[i] = (double)_batch(vm, *dict[w], m) / m;
+        o[i] = (double)_batch(vm, _noop, m) / m;
+        vm.ss = ss0; vm.tos = t0;                /// * values it changed in place
+    }
+    sort(o.begin(), o.end());
+    double oh = o[ns / 2];                       ///< overhead per call
+    for (auto &v : t) v = max(0.0, v - oh);     /// * noisy when k is small
+    sort(t.begin(), t.end());
+    double sum = 0;
+    for (auto v : t) sum += v;
+    auto pct = [&t, ns](int p) { return t[min(ns - 1, ns * p / 100)]; };
+    fout << setbase(10) << fixed << setprecision(1)
+         << "  " << n << " runs of " << dict[w]->name << " in " << ns << " samples"
+         << ", ns/call min " << t[0]
+         << " p50 " << pct(50) << " p90 " << pct(90) << " p99 " << pct(99)
+         << " max " << t[ns - 1] << " mean " << sum / ns
+         << " (overhead " << oh << " taken out)" << ENDL;
+    fout << defaultfloat << setprecision(6) << setbase(*vm.base);
+}
+///====================================================================
+///
+///> Profiler - per dictionary word call counts, inclusive and exclusive ticks
+///
+/// Note: while prof_on, nest brackets the body of a dictionary word with
+///       prof_in/prof_out. Exclusive ticks are inclusive ticks less those
+///       of the words it calls, and a recursive word adds inclusive ticks
+///       on its outermost call only. Each VM keeps its own counters, in
+///       blocks that never move (as FD does), so profile can sum them up
+///       while tasks run. A task switched out by yield, ms, or recv keeps
+///       its clock running. Counters follow the token, so profile-reset
+///       after forget.
+///
+#if DO_PROFILE
+#include <algorithm>                   /// sort
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>                 /// __rdtsc
+#define PROF_TICK() (__rdtsc())
+#define PROF_UNIT   "cycles"
+#else  // !x86
+#define PROF_TICK() ((U64)chrono::duration_cast<chrono::nanoseconds>( \
+                        chrono::steady_clock::now().time_since_epoch()).count())
+#define PROF_UNIT   "nsec"
+#endif // x86
+
+struct Prof { U64 n, incl, excl; int dp; };      ///< calls, ticks, recursion depth
+const int    PBSZ  = 256;                        ///< counters per block
+const int    PNBLK = 256;                        ///< blocks, 64K words as FD
+Prof         *_pblk[E4_VM_POOL_SZ][PNBLK] = {}; ///< per VM counter blocks
+U64          _kid[E4_VM_POOL_SZ] = {};           ///< child ticks of running word
+atomic<bool> prof_on { false };
+
+Prof &_prof(int id, IU w) {                      ///> counters of dict[w] on a VM
+    Prof *&b = _pblk[id][w / PBSZ];
+    if (!b) b = new Prof[PBSZ]();                /// * zero filled, owner VM only
+    return b[w % PBSZ];
+}
+PMark prof_in(VM &vm, IU w) {
+    Prof &p = _prof(vm.id, w);
+    p.n++; p.dp++;
+    PMark m = { PROF_TICK(), _kid[vm.id] };      /// * keep caller's child ticks
+    _kid[vm.id] = 0;
+    return m;
+}
+void prof_out(VM &vm, IU w, PMark &m) {
+    U64  dt = PROF_TICK() - m.t0;
+    Prof &p = _prof(vm.id, w);
+    if (p.dp > 0 && --p.dp == 0) p.incl += dt;   /// * outermost call only
+    p.excl += dt - _kid[vm.id];
+    _kid[vm.id] = m.kid + dt;                    /// * one more child of caller
+}
+void prof_reset() {                              ///> depth kept for running words
+    for (auto &v : _pblk) {
+        for (Prof *b : v) {
+            if (!b) continue;
+            for (int i = 0; i < PBSZ; i++) b[i].n = b[i].incl = b[i].excl = 0;
+        }
+    }
+}
+void prof_dump(VM &vm, int base) {               ///> all VMs, costliest first
+    struct Row { IU w; U64 n, incl, excl; };
+    ostringstream &fout = vm.fout;
+    vector<Row>   rows;
+    U64           tot = 0;
+    int           nw  = dict.size();
+    for (int w = 1; w < nw; w++) {
+        Row r = { (IU)w, 0, 0, 0 };
+        for (auto &v : _pblk) {
+            Prof *b = v[w / PBSZ];
+            if (!b) continue;
+            r.n += b[w % PBSZ].n; r.incl += b[w % PBSZ].incl; r.excl += b[w % PBSZ].excl;
+        }
+        if (r.n) { rows.push_back(r); tot += r.excl; }
+    }
+    sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) { return a.excl > b.excl; });
+
+    fout << setbase(10) << setfill(' ') << ENDL;
+    fout << setw(12) << "calls" << setw(16) << "incl " PROF_UNIT
+         << setw(16) << "excl " PROF_UNIT << setw(8) << "excl%" << "  name" << ENDL;
+    for (auto &r : rows) {
+        U64 pm = tot ? r.excl * 1000 / tot : 0;  ///< per mille
+        fout << setw(12) << r.n << setw(16) << r.incl << setw(16) << r.excl
+             << setw(6)  << pm / 10 << '.' << pm % 10 << "  "
+             << dict[r.w]->name << ENDL;
+    }
+    fout << setbase(base);
+}
+#endif // DO_PROFILE
+///
+///> Code map - primitives by code address, for the sampler and perf
+///
+/// Note: a primitive is a lambda whose code is [xt, xt + size), sized by
+///       the ELF symbol table of the executable (Linux, not stripped) or,
+///       when stripped, by the gap to the next primitive. Colon words
+///       have no machine code of their own, they run in Code::nest
+///
+#if DO_SAMPLE || DO_PERF
+#include <algorithm>                   /// sort
+#include <fstream>
+#include <unordered_map>
+#if defined(__linux__)
+#include <link.h>                      /// dl_iterate_phdr, ElfW
+#endif // __linux__
+
+struct XtMap { UFP a, z; IU w; };                ///< code of dict[w] is [a, z)
+const UFP XT_GAP = 4096;                         ///< max size taken from a gap
+
+void _xt_map(vector<XtMap> &m) {                 ///> primitives, sorted by address
+    unordered_map<UFP, UFP> fn;                  ///< function start => size
+#if defined(__linux__)
+    UFP base = 0;                                ///< load address, PIE
+    dl_iterate_phdr([](struct dl_phdr_info *i, size_t, void *p) {
+        *(UFP*)p = i->dlpi_addr; return 1;       /// * first one is the executable
+    }, &base);
+    ifstream f("/proc/self/exe", ios::binary);
+    string   e((istreambuf_iterator<char>(f)), istreambuf_iterator<char>());
+    auto     *h = (ElfW(Ehdr)*)e.data();
+    if (e.size() > sizeof(*h) && !memcmp(h->e_ident, ELFMAG, SELFMAG) &&
+        h->e_shoff + (size_t)h->e_shnum * sizeof(ElfW(Shdr)) <= e.size()) {
+        auto *sh = (ElfW(Shdr)*)(e.data() + h->e_shoff);
+        for (int i = 0; i < h->e_shnum; i++) {
+            if (sh[i].sh_type != SHT_SYMTAB ||
+                sh[i].sh_offset + sh[i].sh_size > e.size()) continue;
+            auto *sym = (ElfW(Sym)*)(e.data() + sh[i].sh_offset);
+            int  n    = (int)(sh[i].sh_size / sizeof(ElfW(Sym)));
+            for (int j = 0; j < n; j++) {
+                if (ELF64_ST_TYPE(sym[j].st_info) == STT_FUNC && sym[j].st_size)
+                    fn[base + sym[j].st_value] = sym[j].st_size;
+            }
+        }
+    }
+#endif // __linux__
+    m.clear();
+    for (auto c : dict) {                        /// * rom words, dict[token]==c
+        int t = c->token;
+        if (!c->xt || !t || t >= dict.size() || dict[t] != c) continue;
+        auto it = fn.find((UFP)c->xt);
+        m.push_back({ (UFP)c->xt, it == fn.end() ? 0 : it->first + it->second, (IU)t });
+    }
+    sort(m.begin(), m.end(), [](const XtMap &a, const XtMap &b) { return a.a < b.a; });
+    for (size_t i = 0; i < m.size(); i++) {      /// * no symbol, up to the next one
+        if (m[i].z) continue;
+        m[i].z = i + 1 < m.size() ? min(m[i + 1].a, m[i].a + XT_GAP) : m[i].a + 1;
+    }
+}
+#endif // DO_SAMPLE || DO_PERF
+///
+///> Sampler - SIGPROF samples of Forth call chains, as folded stacks
+///
+/// Note: nest keeps colon words on a shadow stack in each VM, a few
+///       stores per colon call and none per primitive. The ITIMER_PROF
+///       signal lands on a thread using CPU, and the handler adds the
+///       call chain of the VM that thread runs (smp_vid) to a fixed hash
+///       table, no allocation nor lock wait in the handler. The leaf
+///       primitive is the one whose code holds the interrupted PC (see
+///       Code map); a PC elsewhere (nest, library) counts for the colon
+///       word. A sample that finds the table busy or full is counted as
+///       lost.
+///       A line of samples reads
+///           VM1;main;work;dup 42
+///       ready for flamegraph.pl. Threads with no VM show as [other].
+///
+#if DO_SAMPLE
+#include <signal.h>
+#include <sys/time.h>                  /// setitimer
+#include <ucontext.h>                  /// interrupted PC
+
+struct Smp {                                     ///< one distinct call chain
+    U32 h;                                       ///< hash, 0=empty slot
+    int vid;                                     ///< VM id, -1=no VM
+    int n;                                       ///< # of words in w
+    U64 cnt;                                     ///< # of samples
+    IU  w[E4_SMP_DEPTH + 1];                     ///< outermost first, leaf last
+};
+thread_local int smp_vid = -1;
+Smp         *_smp = NULL;                        ///< E4_SMP_SLOTS, open addressing
+atomic_flag _smp_lck = ATOMIC_FLAG_INIT;         ///< handler or dump owns _smp
+atomic<U64> _smp_lost { 0 };
+vector<XtMap> _xmap;                             ///< sorted, built before sampling
+
+IU _smp_word(Code *c) {                          ///> dict index of c, 0=not a word
+    int t = c ? (int)c->token : 0;
+    return (t && t < dict.size() && dict[t]==c) ? (IU)t : 0;
+}
+IU _smp_leaf(void *ctx) {                        ///> primitive at interrupted PC
+    mcontext_t &mc = ((ucontext_t*)ctx)->uc_mcontext;
+#if defined(__linux__) && defined(__x86_64__)
+    UFP pc = (UFP)mc.gregs[REG_RIP];
+#elif defined(__linux__) && defined(__aarch64__)
+    UFP pc = (UFP)mc.pc;
+#else  // no PC, colon words only
+    UFP pc = 0; (void)mc;
+#endif // __linux__
+    int lo = 0, hi = (int)_xmap.size() - 1;     /// * last a <= pc
+    if (hi < 0 || pc < _xmap[0].a) return 0;
+    while (lo < hi) {
+        int m = (lo + hi + 1) / 2;
+        if (_xmap[m].a <= pc) lo = m; else hi = m - 1;
+    }
+    return pc < _xmap[lo].z ? _xmap[lo].w : 0;
+}
+void _smp_tick(int, siginfo_t*, void *ctx) {     ///> SIGPROF handler
+    if (!_smp || _smp_lck.test_and_set(memory_order_acquire)) { _smp_lost++; return; }
+    Smp s = {};
+    s.vid = smp_vid;
+    if (s.vid >= 0) {                            /// * walk VM shadow stack
+        VM  &vm = vm_get(s.vid);
+        int dp  = vm.sdp;
+        for (int i = 0; i < dp && i < E4_SMP_DEPTH; i++) {
+            IU t = _smp_word(vm.sp[i]);
+            if (t) s.w[s.n++] = t;
+        }
+        IU t = _smp_leaf(ctx);                   /// * primitive being run
+        if (t) s.w[s.n++] = t;
+    }
+    U32 h = 2166136261u ^ (U32)(s.vid + 1);      /// * FNV-1a of the chain
+    for (int i = 0; i < s.n; i++) h = (h ^ s.w[i]) * 16777619u;
+    s.h = h ? h : 1;
+
+    bool hit = false;
+    for (int i = 0; i < E4_SMP_SLOTS && !hit; i++) {
+        Smp &e = _smp[(s.h + i) % E4_SMP_SLOTS];
+        if (!e.h) { e = s; hit = true; }         /// * new chain
+        else if (e.h == s.h && e.vid == s.vid && e.n == s.n &&
+                 !memcmp(e.w, s.w, s.n * sizeof(IU))) hit = true;
+        if (hit) e.cnt++;
+    }
+    if (!hit) _smp_lost++;                       /// * table full
+    _smp_lck.clear(memory_order_release);
+}
+void _smp_lock() { while (_smp_lck.test_and_set(memory_order_acquire)) this_thread::yield(); }
+
+void smp_start(int hz) {
+    if (!_smp) _smp = new Smp[E4_SMP_SLOTS]();   /// * before the first signal
+    smp_stop();                                  /// * no more ticks, then wait
+    _smp_lock();                                 /// * for one still in the handler
+    _xt_map(_xmap);                              /// * words defined since
+    _smp_lck.clear(memory_order_release);
+    struct sigaction sa = {};
+    sa.sa_sigaction = _smp_tick;
+    sa.sa_flags     = SA_RESTART | SA_SIGINFO;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, NULL);
+
+    long us = 1000000L / (hz > 0 ? hz : 1);
+    struct itimerval it = { { us / 1000000L, us % 1000000L }, { us / 1000000L, us % 1000000L } };
+    setitimer(ITIMER_PROF, &it, NULL);
+}
+void smp_stop() {
+    struct itimerval it = {};
+    setitimer(ITIMER_PROF, &it, NULL);           /// * handler stays, no more ticks
+}
+void smp_reset() {
+    if (!_smp) return;
+    _smp_lock();
+    for (int i = 0; i < E4_SMP_SLOTS; i++) _smp[i] = {};
+    _smp_lost = 0;
+    _smp_lck.clear(memory_order_release);
+}
+void smp_dump(VM &vm) {
+    ostringstream &fout = vm.fout;
+    fout << setbase(10) << ENDL;
+    if (_smp) {
+        _smp_lock();                             /// * a tick now is counted lost
+        for (int i = 0; i < E4_SMP_SLOTS; i++) {
+            Smp &e = _smp[i];
+            if (!e.h) continue;
+            if (e.vid < 0) fout << "[other]";
+            else           fout << "VM" << e.vid;
+            for (int j = 0; j < e.n; j++) fout << ';' << dict[e.w[j]]->name;
+            fout << ' ' << e.cnt << ENDL;
+        }
+        _smp_lck.clear(memory_order_release);
+    }
+    if (_smp_lost) { fout << "[lost] " << _smp_lost << ENDL; }
+    fout << setbase(*vm.base);
+}
+#endif // DO_SAMPLE
+///
+///> perf map and jitdump - Forth names for primitives in perf
+///
+/// Note: perf reads /tmp/perf-<pid>.map only for code in anonymous
+///       memory, and the primitives are in the executable, so their
+///       code is also written as JIT_CODE_LOAD records of a jitdump
+///       (mmap'ed PROT_EXEC as a marker for perf record), which
+///       perf inject --jit turns into symbols over the same addresses
+///           perf record -k 1 ./tests/eforth < app.fs
+///           perf inject --jit -i perf.data -o perf.jit.data
+///           perf report -i perf.jit.data
+///
+#if DO_PERF
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct JitHdr {                                  ///< jitdump file header
+    U32 magic, version, size, mach, pad, pid;
+    U64 ts, flags;
+};
+struct JitLoad {                                 ///< JIT_CODE_LOAD record
+    U32 id, size;                                ///< record header
+    U64 ts;
+    U32 pid, tid;
+    U64 vma, addr, len, idx;                     ///< then name, then code
+};
+U64 _mono() {                                    ///> perf record -k 1 clock
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (U64)t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+void perf_map() {
+    vector<XtMap> m;
+    _xt_map(m);
+    U32    pid = (U32)getpid();
+    string pfx = "/tmp/perf-" + to_string(pid);
+    ofstream f(pfx + ".map");
+    f << hex;
+    for (auto &x : m) f << x.a << ' ' << x.z - x.a << " forth:" << dict[x.w]->name << '\n';
+
+    string jn = "/tmp/jit-" + to_string(pid) + ".dump";
+    ofstream j(jn, ios::binary);
+    JitHdr h = {
+        0x4A695444, 1, sizeof(JitHdr),           /// * 'JiTD', version 1
+#if defined(__x86_64__)
+        EM_X86_64,
+#elif defined(__aarch64__)
+        EM_AARCH64,
+#else  // other
+        EM_NONE,
+#endif // __x86_64__
+        0, pid, _mono(), 0
+    };
+    j.write((const char*)&h, sizeof(h)).flush();
+    int fd = open(jn.c_str(), O_RDONLY);         /// * marker, kept till exit
+    if (fd >= 0) {
+        mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+        close(fd);
+    }
+    U32 tid = (U32)syscall(SYS_gettid);
+    U64 idx = 0;
+    for (auto &x : m) {
+        string   nm = string("forth:") + dict[x.w]->name;
+        U64      n  = x.z - x.a;
+        JitLoad  r  = {
+            0, (U32)(sizeof(JitLoad) + nm.size() + 1 + n), _mono(),
+            pid, tid, x.a, x.a, n, idx++
+        };
+        j.write((const char*)&r, sizeof(r));
+        j.write(nm.c_str(), nm.size() + 1);
+        j.write((const char*)x.a, n);            /// * the code itself
+    }
+}
+#endif // DO_PERF
+///
+///> Hardware counters - perf_event_open around a code region
+///
+/// Note: counters are opened once per thread, user space only (allowed
+///       at perf_event_paranoid 2), and read as value * enabled/running
+///       when the PMU multiplexes them. A green thread moved to another
+///       worker between pmc-start and pmc-stop counts on the old one,
+///       so measure on VM0. A counter the kernel (or a VM) refuses shows
+///       as not supported, and pmc-start reports when none opens.
+///
+#if DO_PMC
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct PmcEv { U32 type; U64 cfg; const char *nm; };
+const PmcEv PMC_EV[] = {
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK,        "task-clock"       },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,        "cycles"           },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,      "instructions"     },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS, "branches"       },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES,     "branch-misses"    },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES,  "cache-references" },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,      "cache-misses"     }
+};
+const int PMC_N = sizeof(PMC_EV) / sizeof(PmcEv);
+struct Pmc {                                     ///< per thread
+    bool open = false;
+    int  fd[PMC_N];                              ///< -1=not supported
+    int  err  = 0;                               ///< errno of first failure
+    U64  v[PMC_N], en[PMC_N], run[PMC_N];        ///< last read
+};
+thread_local Pmc _pmc;
+
+bool _pmc_open() {                               ///> false if none opened
+    Pmc &p = _pmc;
+    if (p.open) return true;
+    int ok = 0;
+    for (int i = 0; i < PMC_N; i++) {
+        struct perf_event_attr a = {};
+        a.type           = PMC_EV[i].type;
+        a.size           = sizeof(a);
+        a.config         = PMC_EV[i].cfg;
+        a.disabled       = 1;
+        a.exclude_kernel = 1;
+        a.exclude_hv     = 1;
+        a.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        p.fd[i] = (int)syscall(SYS_perf_event_open, &a, 0, -1, -1, 0); /// * this thread, any CPU
+        if (p.fd[i] >= 0) ok++;
+        else if (!p.err) p.err = errno;
+    }
+    if (!ok) return false;                       /// * try again next time
+    p.open = true;
+    return true;
+}
+void pmc_start(VM &vm) {
+    if (!_pmc_open()) {
+        ostringstream &fout = vm.fout;
+        fout << "  ?no perf counters, " << strerror(_pmc.err)
+             << " (see /proc/sys/kernel/perf_event_paranoid)" << ENDL;
+        return;
+    }
+    for (int f : _pmc.fd) if (f >= 0) ioctl(f, PERF_EVENT_IOC_RESET, 0);
+    for (int f : _pmc.fd) if (f >= 0) ioctl(f, PERF_EVENT_IOC_ENABLE, 0);
+}
+void pmc_stop() {
+    Pmc &p = _pmc;
+    if (!p.open) return;
+    for (int f : p.fd) if (f >= 0) ioctl(f, PERF_EVENT_IOC_DISABLE, 0);
+    for (int i = 0; i < PMC_N; i++) {
+        U64 r[3] = { 0, 0, 0 };                  ///< value, enabled, running
+        if (p.fd[i] < 0 || read(p.fd[i], r, sizeof(r)) != sizeof(r)) r[0] = r[1] = r[2] = 0;
+        p.v[i] = r[2] ? (U64)((double)r[0] * r[1] / r[2]) : 0;
+        p.en[i] = r[1]; p.run[i] = r[2];
+    }
+}
+void pmc_dump(VM &vm) {
+    ostringstream &fout = vm.fout;
+    Pmc &p = _pmc;
+    if (!p.open) { fout << "  ?no perf counters, pmc-start first" << ENDL; return; }
+    auto rate = [&fout, &p](int i, int j, const char *u) {
+        if (p.fd[i] < 0 || p.fd[j] < 0 || !p.v[j]) return;
+        fout << setw(10) << setprecision(2) << fixed
+             << 100.0 * p.v[i] / p.v[j] << "% of " << u;
+    };
+    fout << setbase(10) << setfill(' ') << ENDL;
+    for (int i = 0; i < PMC_N; i++) {
+        fout << setw(18) << PMC_EV[i].nm;
+        if (p.fd[i] < 0) { fout << "    <not supported>" << ENDL; continue; }
+        fout << setw(16) << p.v[i];
+        switch (i) {
+        case 0: fout << " ns"; break;
+        case 2:
+            if (p.fd[1] >= 0 && p.v[1])
+                fout << setw(10) << setprecision(2) << fixed
+                     << (double)p.v[2] / p.v[1] << " IPC";
+            break;
+        case 4: rate(4, 3, "branches");         break;
+        case 6: rate(6, 5, "cache-references"); break;
+        }
+        if (p.run[i] < p.en[i])                  /// * multiplexed, scaled
+            fout << "  (" << (p.en[i] ? 100 * p.run[i] / p.en[i] : 0) << "% counted)";
+        fout << ENDL;
+    }
+    fout << defaultfloat << setprecision(6) << setbase(*vm.base);
+}
+#endif // DO_PMC
 ///====================================================================
@@ -4,7 +4,7 @@
 ///
 #include "ceforth.h"
 
-extern FV<Code*> dict;             ///< Forth dictionary
+extern FD<Code*> dict;             ///< Forth dictionary
 
 #if !DO_MULTITASK
 VM _vm0;                           ///< singleton, no VM pooling
@@ -32,6 +32,7 @@ VM& vm_get(int id) {
 ///> VM messaging and IO control variables
 ///
 int      VM::NCORE   = 1;          ///< default to 1, updated in init
+int      VM::BATCH   = 64;         ///< items per pipeline hand-off
 bool     VM::io_busy = false;
 MUTEX    VM::io;
 MUTEX    VM::tsk;
@@ -49,11 +50,331 @@ vector<THREAD> _pool;                             ///< thread pool
 queue<VM*>     _que;                              ///< event queue, thread-safe?
 MUTEX          _evt;                              ///< mutex for queue access
 COND_VAR       _cv_evt;                           ///< for pool exit
-bool           _quit = 0;                         ///< thread pool exit flag
+atomic<bool>   _quit { false };                   ///< thread pool exit flag
+THREAD         _timer;                            ///< timer service thread
+MUTEX          _tmr;                              ///< timer wheel access
+COND_VAR       _cv_tmr;                           ///< wakes an idle timer thread
+void _timer_loop();                               ///< see Timer wheel below
+#if DO_MPI
+int            _node  = 0;                        ///< rank of this process
+int            _nodes = 1;                        ///< # of processes
+void _mpi_init();                                 ///< see Multi-process transport below
+void _mpi_stop();
+void _mpi_send(VM &vm, int tid, int n);
+#endif // DO_MPI
+#if DO_TRACE
+///
+///> Tracer - task events, dumped as Chrome trace-event JSON
+///
+/// Note: each thread appends to a buffer of its own and publishes the
+///       count with a release store, so recording takes no lock and a
+///       dump (from any thread) reads up to the count it sees. A full
+///       buffer drops events. Worker runs and idles go onto a lane per
+///       worker (T0, T1, ..), the others onto a lane per VM (VM0, ..)
+///
+#include <fstream>
+#include <unistd.h>
+struct TEv {                                      ///< one trace event
+    U64 t, d;                                     ///< start, duration in nsec
+    S16 k, vid;                                   ///< trc_kind, VM id
+    S32 a;                                        ///< word, peer VM or worker
+};
+struct TBuf {                                     ///< per thread event buffer
+    int         rank;                             ///< worker rank, -1=other
+    atomic<int> n { 0 };                          ///< events published
+    TEv         ev[E4_TRC_EVENTS];
+};
+const int    TRC_BUFS = 64;                       ///< max threads traced
+const U64    TRC_GAP  = 1000;                     ///< nsec, shorter idles not kept
+const char  *TRC_NAME[] = {                       ///< by trc_kind
+    "run", "idle", "create", "start", "finish", "send", "recv", "pull", "lock"
+};
+atomic<bool> _trc_on  { false };                  ///< recording
+atomic<int>  _trc_nb  { 0 };                      ///< buffers handed out
+atomic<U64>  _trc_lost{ 0 };                      ///< events dropped
+TBuf         *_trc_buf[TRC_BUFS];
+string       _trc_fn;                             ///< output file
+U64          _io_t0  = 0;                         ///< lock taken at (VM::io_busy)
+int          _io_vid = 0;                         ///< by VM
+thread_local TBuf *_tb    = NULL;                 ///< this thread's buffer
+thread_local int   _trank = -1;                   ///< this worker's rank
+const auto   _trc_t0 = chrono::steady_clock::now();
+
+U64 _trc_ns() {                                   ///< nsec since _trc_t0
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - _trc_t0).count();
+}
+U64 _trc_at() {                                   ///< now if recording, 0=off
+    return _trc_on.load(memory_order_relaxed) ? _trc_ns() : 0;
+}
+void _trc(trc_kind k, int vid, U64 t0, int a) {   ///< add event since t0, 0=skip
+    if (!t0) return;
+    if (!_tb) {                                   /// * first event of thread
+        int i = _trc_nb++;
+        if (i >= TRC_BUFS) { _trc_nb--; _trc_lost++; return; }
+        _tb = _trc_buf[i] = new TBuf;
+        _tb->rank = _trank;
+    }
+    int n = _tb->n.load(memory_order_relaxed);
+    U64 t = k >= TRC_CREATE && k <= TRC_FINISH ? t0 : _trc_ns();
+    if (k == TRC_IDLE && t - t0 < TRC_GAP) return;/// * queue was not empty
+    TEv *p = n ? &_tb->ev[n - 1] : NULL;          ///< previous event
+    if (k == TRC_RUN && p && p->k == TRC_RUN && p->vid == vid && t0 - (p->t + p->d) < TRC_GAP) {
+        p->d = t - p->t;                          /// * yielded to nobody, extend
+        return;
+    }
+    if (n >= E4_TRC_EVENTS) { _trc_lost++; return; }
+    _tb->ev[n] = { t0, t - t0, (S16)k, (S16)vid, (S32)a };
+    _tb->n.store(n + 1, memory_order_release);
+}
+void _trc_mark(trc_kind k, int vid, int a) {      ///< instant event
+    _trc(k, vid, _trc_at(), a);
+}
+void trc_start() {
+    if (_trc_fn.empty()) {
+        const char *fn = getenv("E4_TRACE");
+        _trc_fn = fn && *fn ? fn : "eforth." + to_string(getpid()) + ".json";
+    }
+    _trc_on = true;
+}
+void trc_stop() { _trc_on = false; }
+void trc_dump(VM &vm) {
+    ofstream f(_trc_fn);
+    if (!f) { pstr(vm, ("  ?cannot write " + _trc_fn).c_str(), CR); return; }
+
+    int  pid = (int)getpid();
+    int  nb  = min(_trc_nb.load(), TRC_BUFS);
+    long ne  = 0;
+    auto lane = [&f, pid](int tid, const string &nm) {   ///< name and order a lane
+        f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+          << ",\"args\":{\"name\":\"" << nm << "\"}},\n"
+          << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+          << ",\"args\":{\"sort_index\":" << tid << "}},\n";
+    };
+    f << "{\"traceEvents\":[\n" << fixed << setprecision(3);
+    for (int r = 0; r < (int)_pool.size(); r++) lane(r + 1, "T" + to_string(r));
+    for (int i = 0; i < E4_VM_POOL_SZ; i++)     lane(1000 + i, "VM" + to_string(i));
+    for (int b = 0; b < nb; b++) {
+        TBuf *tb = _trc_buf[b];
+        int  n   = tb->n.load(memory_order_acquire);
+        for (int i = 0; i < n; i++, ne++) {
+            TEv &e = tb->ev[i];
+            bool w = e.k == TRC_RUN || e.k == TRC_IDLE;   ///< worker lane
+            bool x = e.k < TRC_CREATE || e.k > TRC_FINISH;///< has duration
+            string nm = e.k == TRC_RUN
+                ? (e.a >= 0 ? string(dict[e.a]->name) : "VM" + to_string(e.vid))
+                : TRC_NAME[e.k];
+            f << "{\"name\":" << json_str(nm.c_str())
+              << ",\"cat\":\"" << TRC_NAME[e.k]
+              << "\",\"ph\":\"" << (x ? "X" : "i")
+              << "\",\"ts\":" << e.t / 1000.0;
+            if (x) f << ",\"dur\":" << e.d / 1000.0;
+            else   f << ",\"s\":\"t\"";
+            f << ",\"pid\":" << pid
+              << ",\"tid\":" << (w ? tb->rank + 1 : 1000 + e.vid)
+              << ",\"args\":{";
+            if (e.vid >= 0) f << "\"vm\":" << e.vid;
+            switch (e.k) {
+            case TRC_CREATE: if (e.a >= 0) f << ",\"word\":" << json_str(dict[e.a]->name); break;
+            case TRC_START:
+            case TRC_FINISH: f << ",\"worker\":" << e.a; break;
+            case TRC_SEND:   f << ",\"to\":"     << e.a; break;
+            case TRC_PULL:   f << ",\"from\":"   << e.a; break;
+            default: break;
+            }
+            f << "}},\n";
+        }
+    }
+    f << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+      << ",\"args\":{\"name\":\"eforth." << pid << "\"}}\n"   /// * last, no comma
+      << "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"lost\":" << _trc_lost.load() << "}}\n";
+    ostringstream &fout = vm.fout;
+    fout << "trace: " << ne << " events, " << _trc_lost.load()
+         << " lost => " << _trc_fn << ENDL;
+}
+#define TRC_T0           U64 _trc_t0_ = _trc_at()
+#define TRC(k, vid, a)   _trc(k, vid, _trc_t0_, a)
+#define TRC_MARK(k, vid, a) _trc_mark(k, vid, a)
+#else  // !DO_TRACE
+#define TRC_T0
+#define TRC(k, vid, a)
+#define TRC_MARK(k, vid, a)
+#endif // DO_TRACE
+
+void _enqueue(VM *vm) {                           ///< add a ready-to-run VM
+    GUARD(_evt);
+    _que.push(vm);                                /// create event
+    NOTIFY(_cv_evt);
+}
+thread_local int _rank = -1;                      ///< worker rank, -1=main thread
+void _task_cpu(VM *vm, bool in);                  ///< onto a pinned task's CPU, or back
+#if DO_COROUTINE
+///
+///> Green threads
+///
+/// Note: a pool VM runs on its own stack, so when it waits (yield,
+///       recv, join, ms) it switches back to the worker which then
+///       picks up the next VM from the event queue. A waiting VM is
+///       either requeued (yield) or parked until another VM wakes it.
+///
+thread_local ucontext_t _host;                    ///< worker context
+
+void _vm_entry(int id) {
+    VM &vm = vm_get(id);
+    (vm.xp ? vm.xp.load() : dict[vm.wp])->nest(vm);      /// * run the task
+    vm.live = false;
+    setcontext(vm.host);                          /// * back to worker, no return
+}
+
+void _resume(VM *vm, int rank) {
+    if (!vm->live) {                              /// * fresh task
+        if (!vm->ctx) {                           /// * allocate once, reused
+            vm->ctx = new ucontext_t;
+            vm->stk = new char[E4_VM_STACK_SZ];
+        }
+        getcontext(vm->ctx);
+        vm->ctx->uc_stack.ss_sp   = vm->stk;
+        vm->ctx->uc_stack.ss_size = E4_VM_STACK_SZ;
+        vm->ctx->uc_link          = NULL;
+        makecontext(vm->ctx, (void(*)())_vm_entry, 1, (int)vm->id);
+        vm->live = true;
+        VM_LOG(vm, ">> started on T%d", rank);
+        TRC_MARK(TRC_START, vm->id, rank);
+    }
+    vm->host = &_host;
+    _task_cpu(vm, true);                          /// * worker follows a pinned task
+    TRC_T0;
+    swapcontext(&_host, vm->ctx);                 /// * run until VM switches back
+    TRC(TRC_RUN, vm->id, vm->xp ? -1 : vm->wp);
+    _task_cpu(vm, false);                         /// * and goes back to its own CPU
+
+    if (!vm->live) {                              /// * task completed
+        VM_LOG(vm, ">> finished on T%d", rank);
+        TRC_MARK(TRC_FINISH, vm->id, rank);
+        fout_flush(vm->fout);                     /// * partial line left
+        vm->stop();                               /// * release any waiter
+        return;
+    }
+    GUARD(VM::tsk);
+    if (vm->park && !vm->wake) vm->parked = true; /// * stay off the queue
+    else {                                        /// * yield, or woken already
+        vm->wait_id = -1;
+        _enqueue(vm);
+    }
+    vm->park = vm->wake = false;
+}
+#endif // DO_COROUTINE
+///
+///> wake pool VMs waiting on VM[id] (VM::tsk locked by caller)
+///
+void _wake(int id) {
+#if DO_COROUTINE
+    for (int i = 1; i < E4_VM_POOL_SZ; i++) {
+        VM &vm = vm_get(i);
+        if (vm.wait_id != id) continue;
+        if (vm.parked) {                          /// * put back onto the queue
+            vm.parked  = false;
+            vm.wait_id = -1;
+            _enqueue(&vm);
+        }
+        else if (vm.park) vm.wake = true;         /// * worker will requeue it
+    }
+#endif // DO_COROUTINE
+}
+///
+///> wait on VM[id] until cond() holds, then act(), both with VM::tsk locked
+///
+/// Note: a pool VM parks and frees its worker, VM0 blocks its thread
+///
+template<typename C, typename A>
+void _wait(VM &vm, int id, C cond, A act) {
+#if DO_COROUTINE
+    while (vm.live) {
+        {
+            GUARD(VM::tsk);
+            if (cond() || _quit) { act(); NOTIFY(VM::cv_tsk); return; }
+            vm.wait_id = id;
+            vm.park    = true;                    /// * committed by worker
+        }
+        vm.yield();
+    }
+#endif // DO_COROUTINE
+    XLOCK(VM::tsk);
+    WAIT(VM::cv_tsk, [&cond]{ return cond() || _quit; });
+    act();
+    NOTIFY(VM::cv_tsk);
+}
+
+///
+///> futex - sleep until a 32-bit word changes from v, no lock (Linux)
+///
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+static_assert(sizeof(atomic<vm_state>) == sizeof(int), "futex needs a 32-bit state");
+
+void _futex_wait(atomic<vm_state> &a, vm_state v) {
+    struct timespec t = { 0, 100000000 };        ///< 100ms, to notice _quit
+    syscall(SYS_futex, reinterpret_cast<int*>(&a), FUTEX_WAIT_PRIVATE, (int)v, &t, NULL, 0);
+}
+void _futex_wake(atomic<vm_state> &a) {
+    syscall(SYS_futex, reinterpret_cast<int*>(&a), FUTEX_WAKE_PRIVATE, 0x7fffffff, NULL, NULL, 0);
+}
+#endif // __linux__
+///
+///> wake VMs waiting on vm's state, lock-free when nobody waits
+///
+/// Note: the state is stored before nwait is read, and a waiter bumps
+///       nwait before it reads the state (both seq_cst), so either the
+///       waiter sees the new state or we see the waiter
+///
+void _notify(VM &vm) {
+    if (!vm.nwait.load()) return;                 /// * fast path
+#if defined(__linux__)
+    _futex_wake(vm.state);                        /// * threads in _wait_vm
+#endif // __linux__
+    GUARD(VM::tsk);
+    _wake(vm.id);                                 /// * parked green threads
+    NOTIFY_ALL(VM::cv_tsk);
+}
+///
+///> wait until cond() holds on vm's state, then act()
+///
+/// Note: the fast path takes no lock, a green thread parks as in _wait,
+///       VM0 (or a worker thread) sleeps on a futex of the state word
+///
+template<typename C, typename A>
+void _wait_vm(VM &me, VM &vm, C cond, A act) {
+    if (cond()) { act(); return; }                /// * fast path, lock-free
+    vm.nwait++;
+#if defined(__linux__)
+#if DO_COROUTINE
+    if (me.live) _wait(me, vm.id, cond, act);
+    else
+#endif // DO_COROUTINE
+    {
+        while (true) {
+            vm_state s = vm.state.load();
+            if (cond()) { act(); break; }
+            if (_quit)  break;
+            _futex_wait(vm.state, s);             /// * returns at once if changed
+        }
+    }
+#else  // !__linux__
+    _wait(me, vm.id, cond, act);                  /// * VM::tsk and cv_tsk
+#endif // __linux__
+    vm.nwait--;
+}
 
 void _event_loop(int rank) {
     VM *vm = NULL;
+    _rank = rank;
+#if DO_TRACE
+    _trank = rank;                                /// * lane of this worker
+#endif // DO_TRACE
     while (true) {
+        TRC_T0;
         {
             XLOCK(_evt);                          ///< lock queue
             WAIT(_cv_evt, []{ return !_que.empty() || _quit; });
@@ -66,43 +387,266 @@ void _event_loop(int rank) {
             
             NOTIFY(_cv_evt);                      /// * notify one
         }
+        TRC(TRC_IDLE, -1, 0);
+#if DO_SAMPLE
+        smp_vid = vm->id;                         /// * samples go to this VM
+#endif // DO_SAMPLE
+#if DO_COROUTINE
+        _resume(vm, rank);
+#else  // !DO_COROUTINE
         VM_LOG(vm, ">> started on T%d", rank);
-        dict[vm->wp]->nest(*vm);
+        TRC_MARK(TRC_START, vm->id, rank);
+        {
+            TRC_T0;
+            (vm->xp ? vm->xp.load() : dict[vm->wp])->nest(*vm);
+            TRC(TRC_RUN, vm->id, vm->xp ? -1 : vm->wp);
+        }
+        _task_cpu(vm, false);                     /// * undo pin of the task
         VM_LOG(vm, ">> finished on T%d", rank);
+        TRC_MARK(TRC_FINISH, vm->id, rank);
 
+        fout_flush(vm->fout);                     /// * partial line left
         vm->stop();                               /// * release any lock
+#endif // DO_COROUTINE
+#if DO_SAMPLE
+        smp_vid = -1;                             /// * idle worker
+#endif // DO_SAMPLE
     }
 }
 
-void t_pool_init() {
-    VM::NCORE = thread::hardware_concurrency();   ///< number of cores
-    
-    /// setup thread pool and CPU affinity
-    for (int i = 0; i < E4_VM_POOL_SZ; i++) {     ///< loop thru ranks
-        _pool.emplace_back(_event_loop, (int)_vm[i].id);
+///
+///> CPU topology and worker placement
+///
+/// Note: on Linux, topology is read from /sys so workers can be placed
+///       by policy, otherwise worker i goes to core i % NCORE
+///
+#if defined(__linux__)
+#include <fstream>
+#include <algorithm>
+#include <array>
+#include <set>
+struct Cpu {
+    int id, pkg, node, llc, core, smt;
+    int cr, lr;                                   ///< rank of core in its llc, of llc in its pkg
+};
+vector<Cpu> _cpu;                                 ///< usable CPUs
+
+int _sys_int(const string &fn, int v=0) {         ///< read an int from /sys
+    ifstream f(fn);
+    f >> v;
+    return v;
+}
+int _sys_list(const string &fn) {                 ///< first CPU of a cpulist
+    ifstream f(fn);
+    int v = -1;
+    return (f >> v) ? v : -1;
+}
+bool _sys_has(const string &fn, int cpu) {        ///< is cpu in a cpulist
+    ifstream f(fn);
+    string r;
+    while (getline(f, r, ',')) {                  /// * e.g. 0-3,8-11
+        int lo = -1, hi = -1;
+        if (sscanf(r.c_str(), "%d-%d", &lo, &hi) < 2) hi = lo;
+        if (lo >= 0 && cpu >= lo && cpu <= hi) return true;
+    }
+    return false;
+}
+void _topology() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set)) return;
 
+    const string sys = "/sys/devices/system/";
+    for (int i = 0; i < CPU_SETSIZE; i++) {
+        if (!CPU_ISSET(i, &set)) continue;        /// * not allowed to run on
+        string d = sys + "cpu/cpu" + to_string(i) + "/";
+        Cpu c { i, 0, 0, -1, i, 0, 0, 0 };
+        c.pkg  = _sys_int(d + "topology/physical_package_id");
+        c.core = _sys_int(d + "topology/core_id", i);
+        c.smt  = _sys_list(d + "topology/thread_siblings_list") == i ? 0 : 1;
+        for (int n = 0, lv = 0; n < 8; n++) {     /// * last level cache
+            string x = d + "cache/index" + to_string(n) + "/";
+            int l = _sys_int(x + "level", -1);
+            if (l > lv) { lv = l; c.llc = _sys_list(x + "shared_cpu_list"); }
+        }
+        for (int n = 0; n < 64; n++) {            /// * NUMA node
+            if (_sys_has(sys + "node/node" + to_string(n) + "/cpulist", i)) {
+                c.node = n; break;
+            }
+        }
+        _cpu.push_back(c);
+    }
+    for (auto &c : _cpu) {                        /// * ranks for scatter
+        std::set<int> core, llc;
+        for (auto &x : _cpu) {
+            if (x.node != c.node || x.pkg != c.pkg) continue;
+            llc.insert(x.llc);
+            if (x.llc == c.llc) core.insert(x.core);
+        }
+        c.cr = (int)distance(core.begin(), core.find(c.core));
+        c.lr = (int)distance(llc.begin(),  llc.find(c.llc));
+    }
+}
+///
+///> order CPUs for a placement policy
+///   compact  - fill SMT siblings, then cores sharing a cache/package
+///   scatter  - one core of each llc of each node/package first, then
+///              the next core of each, SMT last
+///   physical - one worker per physical core, SMT siblings only if needed
+///
+vector<int> _placement(int policy) {
+    vector<Cpu> v(_cpu);
+    auto key = [policy](const Cpu &c) -> array<int, 7> {
+        switch (policy) {
+        case PIN_COMPACT:  return { c.node, c.pkg, c.llc, c.core, c.smt, c.id, 0 };
+        case PIN_SCATTER:  return { c.smt, c.cr, c.lr, c.node, c.pkg, c.llc, c.id };
+        default:           return { c.smt, c.node, c.pkg, c.llc, c.core, c.id, 0 };
+        }
+    };
+    stable_sort(v.begin(), v.end(),
+                [&key](const Cpu &a, const Cpu &b) { return key(a) < key(b); });
+    vector<int> r;
+    for (auto &c : v) r.push_back(c.id);
+    return r;
+}
+#endif // __linux__
+
+#if __has_include(<sched.h>) && !defined(__CYGWIN__)
+cpu_set_t   _any;                                 ///< CPUs the process may use
+#endif // __has_include(<sched.h>)
+atomic<int> *_wcpu = NULL;                        ///< CPU of each worker, -1=any
+
+void _pin(THREAD::native_handle_type t, int cpu, int rank) {
 #if __has_include(<sched.h>) && !defined(__CYGWIN__)
-        pthread_t t   = _pool.back().native_handle();
-        cpu_set_t set;
+    cpu_set_t set = _any;                         /// * cpu < 0, unpin
+    if (cpu >= 0) {
         CPU_ZERO(&set);                           /// * clear affinity
-        CPU_SET(i % VM::NCORE, &set);             /// * set CPU affinity
-        int rc = pthread_setaffinity_np(          /// * set core affinity
-            t, sizeof(cpu_set_t), &set
-        );
-        if (rc != 0) {
-            printf("thread[%d] failed to set affinity: %d\n", i, rc);
-        }
+        CPU_SET(cpu, &set);                       /// * set CPU affinity
+    }
+    int rc = pthread_setaffinity_np(              /// * set core affinity
+        t, sizeof(cpu_set_t), &set
+    );
+    if (rc != 0) {
+        printf("thread[%d] failed to set affinity: %d\n", rank, rc);
+    }
 #endif // __has_include(<sched.h>)
+}
+
+void t_pool_place(int policy) {
+    if (policy == PIN_NONE) return;
+#if defined(__linux__)
+    vector<int> cpu = _placement(policy);
+    if (cpu.empty()) return;
+#endif // __linux__
+    for (int i = 0; i < (int)_pool.size(); i++) {
+#if defined(__linux__)
+        _wcpu[i] = cpu[i % cpu.size()];
+#else  // !__linux__
+        _wcpu[i] = i % VM::NCORE;
+#endif // __linux__
+        _pin(_pool[i].native_handle(), _wcpu[i], i);
+    }
+}
+///
+///> pin a task - the worker running a pinned task moves onto its CPU
+///  and back to its own placement when the task switches out or ends
+///
+void _task_cpu(VM *vm, bool in) {
+    if (vm->cpu < 0) return;
+    _pin(pthread_self(), in ? vm->cpu : (_rank < 0 ? -1 : _wcpu[_rank].load()), _rank);
+}
+void t_pin(VM &vm, int cpu) {
+    vm.cpu = cpu < 0 ? -1 : cpu;
+    _pin(pthread_self(), cpu >= 0 ? cpu : (_rank < 0 ? -1 : _wcpu[_rank].load()), _rank);
+}
+
+int t_core() {
+#if defined(__linux__)
+    return sched_getcpu();
+#else  // !__linux__
+    return -1;
+#endif // __linux__
+}
+
+int t_workers() { return (int)_pool.size(); }
+
+void t_topology(VM &vm) {
+    ostringstream &fout = vm.fout;
+#if defined(__linux__)
+    fout << " cpu node pkg llc core smt" << ENDL;
+    for (auto &c : _cpu) {
+        fout << setw(4) << c.id   << setw(5) << c.node
+             << setw(4) << c.pkg  << setw(4) << c.llc
+             << setw(5) << c.core << setw(4) << c.smt << ENDL;
+    }
+#else  // !__linux__
+    fout << "cores=" << VM::NCORE << ENDL;
+#endif // __linux__
+}
+
+void t_pool_init() {
+    VM::NCORE = thread::hardware_concurrency();   ///< number of cores
+#if DO_COROUTINE
+    int nthr  = E4_THREAD_SZ                      ///< workers shared by VMs
+        ? E4_THREAD_SZ                            /// * cores, but at most half the VMs
+        : max(1, min(VM::NCORE, E4_VM_POOL_SZ / 2));
+#else  // !DO_COROUTINE
+    int nthr  = E4_VM_POOL_SZ;                    ///< one worker per VM
+#endif // DO_COROUTINE
+#if defined(__linux__)
+    _topology();
+#endif // __linux__
+#if __has_include(<sched.h>) && !defined(__CYGWIN__)
+    sched_getaffinity(0, sizeof(_any), &_any);    /// * before any pin
+#endif // __has_include(<sched.h>)
+    _wcpu = new atomic<int>[nthr];
+    for (int i = 0; i < nthr; i++) _wcpu[i] = -1;
+    
+    /// setup thread pool and CPU affinity
+    for (int i = 0; i < nthr; i++) {              ///< loop thru ranks
+        _pool.emplace_back(_event_loop, i);
     }
-    printf("CPU cores=%d, thread pool[%d] initialized\n", VM::NCORE, E4_VM_POOL_SZ);
+    t_pool_place(E4_CPU_PLACE);
+    _timer = THREAD(_timer_loop);
+    printf("CPU cores=%d, thread pool[%d] initialized\n", VM::NCORE, nthr);
+#if DO_MPI
+    _mpi_init();                                  /// * attach inbox if launched with -np
+#endif // DO_MPI
+#if DO_TRACE
+    if (getenv("E4_TRACE")) trc_start();          /// * trace from the start
+#endif // DO_TRACE
 }
 
 void t_pool_stop() {
     {
-        GUARD(_evt);
-        _quit = true;                             /// * stop event queue
-        NOTIFY_ALL(_cv_evt);
+        GUARD(VM::tsk);
+        {
+            GUARD(_evt);
+            _quit = true;                         /// * stop event queue
+            NOTIFY_ALL(_cv_evt);
+        }
+#if DO_COROUTINE
+        for (int i = 1; i < E4_VM_POOL_SZ; i++) { /// * let parked VMs bail
+            VM &vm = _vm[i];
+            if (vm.parked) { vm.parked = false; _enqueue(&vm); }
+        }
+#endif // DO_COROUTINE
+        NOTIFY_ALL(VM::cv_tsk);
+    }
+    {
+        GUARD(_tmr);
+        NOTIFY(_cv_tmr);                          /// * stop timer service
     }
+    _timer.join();
+#if DO_MPI
+    _mpi_stop();                                  /// * stop inbox proxy
+#endif // DO_MPI
+#if DO_TRACE
+    if (_trc_nb) trc_dump(vm_get(0));             /// * recorded so far, at exit
+#endif // DO_TRACE
+#if DO_LOCKSTAT
+    t_locks(vm_get(0));
+#endif // DO_LOCKSTAT
     printf("joining thread ");
     int i = (int)_pool.size();
     for (auto &t : _pool) {
@@ -110,6 +654,13 @@ void t_pool_stop() {
         t.join();
     }
     _pool.clear();
+#if DO_COROUTINE
+    for (int i = 1; i < E4_VM_POOL_SZ; i++) {     /// * free green-thread stacks
+        VM &vm = _vm[i];
+        delete vm.ctx;   vm.ctx = NULL;
+        delete[] vm.stk; vm.stk = NULL;
+    }
+#endif // DO_COROUTINE
     
     printf("done!\n");
 }
@@ -135,9 +686,11 @@ int task_create(IU w) {
 
     GUARD(VM::tsk);
     
-    while (i > 0 && _vm[i].state != STOP) --i;
+    while (i > 0 && (_vm[i].state != STOP || _vm[i].xp)) --i;
     if (i > 0) {
         _vm[i].reset(w, HOLD);                    /// ready to run
+        _wake(i);
+        TRC_MARK(TRC_CREATE, i, w);
     }
     NOTIFY(VM::cv_tsk);
     
@@ -149,88 +702,737 @@ void task_start(int tid) {
         printf("main task (tid=0) already running.\n");
         return;
     }
-    VM &vm = vm_get(tid);                        /// fetch VM[id]
+    _enqueue(&vm_get(tid));                      /// fetch VM[id], create event
+}
+///
+///> fork - reserve a free VM to run code c, 0 if pool exhausted
+///
+/// Note: a forked VM stays owned (xp set) after it stops, so its
+///       stack can be collected by the forker before it is reused
+///
+int _fork(Code *c) {
+    int i = E4_VM_POOL_SZ - 1;
+
+    GUARD(VM::tsk);
+
+    while (i > 0 && (_vm[i].state != STOP || _vm[i].xp)) --i;
+    if (i > 0) {
+        _vm[i].reset(0, HOLD);
+        _vm[i].xp = c;                           /// * run c instead of dict[wp]
+        TRC_MARK(TRC_CREATE, i, -1);
+    }
+    return i;
+}
+///
+///> future - run dict[w] on a reserved VM, collected by await
+///
+int task_spawn(IU w) {
+    int t = _fork(dict[w]);
+    if (t) task_start(t);
+    return t;
+}
+///
+///> pdo..ploop - split [i, m) into chunks, fork them onto free VMs
+///
+/// Note: the caller runs the first chunk (and any range left when the
+///       pool runs out of VMs), each forked chunk starts with TOS=0 and
+///       its final TOS is added into the caller's TOS when joined
+///
+void task_pfor(VM &vm, Code &c, DU i, DU m) {
+    DU n = m - i;                                ///< iteration count
+    if (n <= 0) return;
+    
+    int nthr = (int)_pool.size();
+    DU  g    = vm.grain > 0 ? vm.grain : (n + nthr - 1) / nthr;
+    DU  x    = i + g;                            ///< start of forked chunks
+    FV<int> tid;
+    while (x < m) {
+        int t = _fork(&c);
+        if (!t) break;                           /// * pool exhausted
+        
+        DU y = x + g < m ? x + g : m;
+        VM &w = _vm[t];
+        w.tos = DU0;                             /// * reduction identity
+        w.rs  = vm.rs;                           /// * outer loop indices, for j
+        w.rs.push(x); w.rs.push(y);              /// * chunk [x, y)
+        tid.push(t);
+        task_start(t);
+        x = y;
+    }
+    auto serial = [&vm, &c](DU i, DU m) {        ///< run [i, m) on caller
+        vm.rs.push(i); vm.rs.push(m);
+        _loop(vm, c);
+    };
+    serial(i, i + g < m ? i + g : m);            /// * caller's chunk
+    if (x < m) serial(x, m);                     /// * leftover
     
-    GUARD(_evt);
-    _que.push(&vm);                              /// create event
-    NOTIFY(_cv_evt);
+    for (int t : tid) {                          /// * join, reduce, release
+        VM &w = _vm[t];
+        _wait_vm(vm, w, [&w]{ return w.state==STOP; }, [&vm, &w]{
+            vm.tos += w.tos;
+            w.xp    = NULL;
+        });
+    }
+}
+///
+///> par{ .. | .. }par - run each branch on its own VM, join at }par
+///
+/// Note: each branch starts on a copy of the caller's stacks, the caller
+///       runs the first one (and any left when the pool runs out). A
+///       branch takes the top a cells as its inputs, and its results
+///       are what it leaves above them. At }par the inputs are gone and
+///       the results of all branches are pushed, in branch order
+///
+void task_par(VM &vm, Code &c, int a) {
+    int            n   = (int)c.pf.size();       ///< number of branches
+    FV<DU>         ss0 = vm.ss;                  ///< stack at par{
+    DU             t0  = vm.tos;
+    int            d   = (int)ss0.size();
+    int            b   = d > a ? d - a : 0;      ///< depth below the inputs
+    vector<int>    tid(n, 0);
+    vector<FV<DU>> out(n);                       ///< results of each branch
+    auto take = [b](VM &w, FV<DU> &r) {          ///< cells w left above b
+        for (int i = b + 1; i < (int)w.ss.size(); i++) r.push(w.ss[i]);
+        if ((int)w.ss.size() > b) r.push(w.tos);
+    };
+    for (int i = 1; i < n; i++) {                /// * fork all but the first
+        int t = _fork(c.pf[i]);
+        if (!t) break;                           /// * pool exhausted
+        
+        VM &w = _vm[t];
+        w.ss  = ss0;                             /// * copy of caller's stack
+        w.tos = t0;
+        w.rs  = vm.rs;                           /// * and loop indices, for i, j
+        tid[i] = t;
+        task_start(t);
+    }
+    for (int i = 0; i < n; i++) {                /// * caller's share
+        if (tid[i]) continue;
+        c.pf[i]->nest(vm);
+        take(vm, out[i]);
+        vm.ss = ss0; vm.tos = t0;
+    }
+    for (int i = 1; i < n; i++) {                /// * join, collect, release
+        if (!tid[i]) continue;
+        VM &w = _vm[tid[i]];
+        _wait_vm(vm, w, [&w]{ return w.state==STOP; }, [&]{
+            take(w, out[i]);
+            w.xp = NULL;
+        });
+    }
+    while ((int)vm.ss.size() > b) vm.tos = vm.ss.pop();  /// * inputs consumed
+    for (auto &r : out) for (DU v : r) PUSH(v);
+}
+///==================================================================
+///
+///> Channels - bounded MPMC queues with backpressure
+///
+/// Note: the queue is lock-free (D. Vyukov's bounded MPMC ring), tasks
+///       only take VM::tsk to park when a channel is full or empty.
+///       A parked VM waits on a key past the VM ids, 2*ch for data,
+///       2*ch+1 for space, or SEL_KEY for select over many channels.
+///
+struct Chan {
+    struct Cell { atomic<size_t> seq; DU v; };
+    Cell           *buf;                         ///< ring buffer
+    size_t         sz;                           ///< capacity
+    ALIGNAS atomic<size_t> head { 0 };           ///< next pop position
+    ALIGNAS atomic<size_t> tail { 0 };           ///< next push position
+    atomic<int>    nget { 0 };                   ///< # of VMs waiting for data
+    atomic<int>    nput { 0 };                   ///< # of VMs waiting for space
+
+    Chan(int n) : sz(n < 2 ? 2 : n) {            /// * ring needs 2 cells min
+        buf = new Cell[sz];
+        for (size_t i = 0; i < sz; i++) buf[i].seq.store(i, memory_order_relaxed);
+    }
+    ~Chan() { delete[] buf; }
+    bool push(DU v) {
+        size_t p = tail.load(memory_order_relaxed);
+        while (true) {
+            Cell   &c = buf[p % sz];
+            size_t  q = c.seq.load(memory_order_acquire);
+            intptr_t d = (intptr_t)q - (intptr_t)p;
+            if (d == 0) {                        /// * cell free, claim it
+                if (tail.compare_exchange_weak(p, p + 1, memory_order_relaxed)) {
+                    c.v = v;
+                    c.seq.store(p + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if (d < 0) return false;        /// * full
+            else p = tail.load(memory_order_relaxed);
+        }
+    }
+    bool pop(DU &v) {
+        size_t p = head.load(memory_order_relaxed);
+        while (true) {
+            Cell   &c = buf[p % sz];
+            size_t  q = c.seq.load(memory_order_acquire);
+            intptr_t d = (intptr_t)q - (intptr_t)(p + 1);
+            if (d == 0) {                        /// * cell filled, take it
+                if (head.compare_exchange_weak(p, p + 1, memory_order_relaxed)) {
+                    v = c.v;
+                    c.seq.store(p + sz, memory_order_release);
+                    return true;
+                }
+            }
+            else if (d < 0) return false;        /// * empty
+            else p = head.load(memory_order_relaxed);
+        }
+    }
+};
+FD<Chan*>   _chan;                               ///< channel table
+atomic<int> _nsel { 0 };                         ///< # of VMs in select
+const int   CH_KEY  = E4_VM_POOL_SZ;             ///< wait keys after VM ids
+const int   SEL_KEY = CH_KEY + 2 * FD<Chan*>::BSZ * FD<Chan*>::NBLK;
+
+void _chan_wake(int key, bool any) {             ///< wake VMs waiting on key
+    if (!any) return;
+    GUARD(VM::tsk);
+    _wake(key);
+    _wake(SEL_KEY);
+    NOTIFY_ALL(VM::cv_tsk);
+}
+int chan_new(int n) {
+    _chan.push(new Chan(n));
+    return _chan.size() - 1;
+}
+bool chan_tryput(int ch, DU v) {
+    Chan *c = _chan[ch];
+    if (!c->push(v)) return false;
+    atomic_thread_fence(memory_order_seq_cst);   /// * push before waiter check
+    _chan_wake(CH_KEY + 2 * ch, c->nget.load() || _nsel.load());
+    return true;
+}
+bool chan_tryget(int ch, DU &v) {
+    Chan *c = _chan[ch];
+    if (!c->pop(v)) return false;
+    atomic_thread_fence(memory_order_seq_cst);   /// * pop before waiter check
+    _chan_wake(CH_KEY + 2 * ch + 1, c->nput.load() > 0);
+    return true;
+}
+void chan_put(VM &vm, int ch, DU v) {            ///< blocking, backpressure
+    if (chan_tryput(ch, v)) return;              /// * fast path, no lock
+    Chan *c  = _chan[ch];
+    bool  ok = false;
+    c->nput++;                                   /// * before re-check
+    _wait(vm, CH_KEY + 2 * ch + 1, [c, v, &ok]{ return ok = c->push(v); }, []{});
+    c->nput--;
+    if (ok) _chan_wake(CH_KEY + 2 * ch, c->nget.load() || _nsel.load());
+}
+DU chan_get(VM &vm, int ch) {                    ///< blocking until data
+    DU v = DU0;
+    if (chan_tryget(ch, v)) return v;            /// * fast path, no lock
+    Chan *c  = _chan[ch];
+    bool  ok = false;
+    c->nget++;
+    _wait(vm, CH_KEY + 2 * ch, [c, &v, &ok]{ return ok = c->pop(v); }, []{});
+    c->nget--;
+    if (ok) _chan_wake(CH_KEY + 2 * ch + 1, c->nput.load() > 0);
+    return v;
+}
+int chan_select(VM &vm, int *ch, int n, DU &v) { ///< first channel with data
+    for (int i = 0; i < n; i++) {                /// * fast path, no lock
+        if (chan_tryget(ch[i], v)) return ch[i];
+    }
+    int i = -1;                                  ///< index of channel taken
+    auto scan = [ch, n, &v, &i]() {              /// * pop only, VM::tsk is held
+        for (i = 0; i < n; i++) if (_chan[ch[i]]->pop(v)) return true;
+        i = -1;
+        return false;
+    };
+    _nsel++;
+    _wait(vm, SEL_KEY, scan, []{});
+    _nsel--;
+    if (i < 0) return -1;                        /// * quit while waiting
+    _chan_wake(CH_KEY + 2 * ch[i] + 1, _chan[ch[i]]->nput.load() > 0);
+    return ch[i];
+}
+///==================================================================
+///
+///> Pipeline - colon words as stages, each on its own VM
+///
+/// Note: stages are linked by single-producer single-consumer rings
+///       of batches, so a hand-off costs one release store per batch
+///       rather than per item. A stage passes on its partial batch
+///       when its input runs dry, and parks (freeing its worker) when
+///       its input is empty or its output is full.
+///
+struct Link {                                    ///< SPSC ring of batches
+    DU     *buf;                                 ///< nq slots of nb items
+    int    *cnt;                                 ///< items in each slot
+    int    nq, nb;
+    ALIGNAS atomic<size_t> head { 0 };           ///< next slot to take
+    ALIGNAS atomic<size_t> tail { 0 };           ///< next slot to fill
+    atomic<bool>   closed { false };             ///< no more batches
+    atomic<int>    nget { 0 };                   ///< consumer waiting for data
+    atomic<int>    nput { 0 };                   ///< producer waiting for space
+    atomic<U32>    npub { 0 };                   ///< items handed off
+    int    wn = 0;                               ///< producer: items in slot at tail
+    int    rn = 0;                               ///< consumer: items taken from slot at head
+
+    Link(int q, int b) : nq(q), nb(b < 1 ? 1 : b) {
+        buf = new DU[nq * nb];
+        cnt = new int[nq];
+    }
+    ~Link() { delete[] buf; delete[] cnt; }
+    DU   *slot(size_t i) { return &buf[(i % nq) * nb]; }
+    bool full()  { return tail.load(memory_order_relaxed) - head.load(memory_order_acquire) >= (size_t)nq; }
+    bool ready() { return head.load(memory_order_relaxed) != tail.load(memory_order_acquire); }
+};
+struct Stage {
+    IU          w;                               ///< stage word ( v -- v' )
+    atomic<U32> nin  { 0 };                      ///< items taken
+    atomic<U32> nbat { 0 };                      ///< batches taken
+    U32         t0 = 0, t1 = 0;                  ///< start, finish time
+};
+struct Pipe {
+    int   n;                                     ///< # of stages
+    Stage *stg;                                  ///< stages
+    int   *lnk;                                  ///< lnk[i] feeds stage i, lnk[n] is the output
+};
+FD<Link*>   _link;                               ///< link table
+FD<Pipe*>   _pipe;                               ///< pipeline table
+const int   LNK_KEY = SEL_KEY + 1;               ///< wait keys after select's
+
+void _link_wake(int key, bool any) {             ///< wake the VM waiting on key
+    if (!any) return;
+    GUARD(VM::tsk);
+    _wake(key);
+    NOTIFY_ALL(VM::cv_tsk);
+}
+void _link_flush(int l) {                        ///< hand off the batch at tail
+    Link &k = *_link[l];
+    if (!k.wn) return;
+    size_t t = k.tail.load(memory_order_relaxed);
+    k.cnt[t % k.nq] = k.wn;
+    k.npub += k.wn;
+    k.wn    = 0;
+    k.tail.store(t + 1, memory_order_release);
+    atomic_thread_fence(memory_order_seq_cst);   /// * publish before waiter check
+    _link_wake(LNK_KEY + 2 * l, k.nget.load() > 0);
+}
+void _link_close(int l) {
+    Link &k = *_link[l];
+    _link_flush(l);
+    k.closed = true;
+    _link_wake(LNK_KEY + 2 * l, k.nget.load() > 0);
+}
+void _link_put(VM &vm, int l, DU v) {
+    Link &k = *_link[l];
+    if (k.wn == 0 && k.full()) {                 /// * backpressure
+        k.nput++;
+        _wait(vm, LNK_KEY + 2 * l + 1, [&k]{ return !k.full(); }, []{});
+        k.nput--;
+        if (k.full()) return;                    /// * quit while waiting
+    }
+    k.slot(k.tail.load(memory_order_relaxed))[k.wn++] = v;
+    if (k.wn == k.nb) _link_flush(l);
+}
+bool _link_take(VM &vm, int l, DU *&b, int &n) { ///< next batch, false when drained
+    Link &k = *_link[l];
+    if (!k.ready()) {
+        k.nget++;
+        _wait(vm, LNK_KEY + 2 * l, [&k]{ return k.ready() || k.closed.load(); }, []{});
+        k.nget--;
+        if (!k.ready()) return false;            /// * closed (or quit)
+    }
+    size_t h = k.head.load(memory_order_relaxed);
+    b = k.slot(h);
+    n = k.cnt[h % k.nq];
+    return true;
+}
+void _link_release(int l) {                      ///< give slot at head back
+    Link &k = *_link[l];
+    k.head.store(k.head.load(memory_order_relaxed) + 1, memory_order_release);
+    atomic_thread_fence(memory_order_seq_cst);
+    _link_wake(LNK_KEY + 2 * l + 1, k.nput.load() > 0);
+}
+///
+///> stage body, rs holds [pipe, stage]
+///
+void _stage_run(VM &vm, Code &c) {
+    int   s   = INT(RS.pop());
+    Pipe  &p  = *_pipe[INT(RS.pop())];
+    Stage &st = p.stg[s];
+    Code  *w  = dict[st.w];
+    int   in  = p.lnk[s], out = p.lnk[s + 1];
+    DU    *b;
+    int   n;
+    st.t0 = millis();
+    while (true) {
+        if (!_link[in]->ready()) _link_flush(out); /// * idle, pass partial batch on
+        if (!_link_take(vm, in, b, n)) break;
+        for (int i = 0; i < n; i++) {
+            PUSH(b[i]);
+            w->nest(vm);
+            _link_put(vm, out, POP());
+        }
+        st.nin += n;
+        st.nbat++;
+        _link_release(in);
+    }
+    _link_close(out);
+    st.t1 = millis();
+    vm.xp = NULL;                                /// * nobody collects a stage
+}
+Code _stage(_stage_run);                         ///< body of stage VMs
+
+int pipe_new(IU *w, int n) {
+    FV<int> tid;
+    for (int i = 0; i < n; i++) {
+        int t = _fork(&_stage);
+        if (!t) {                                /// * pool exhausted, give back
+            for (int j : tid) { _vm[j].xp = NULL; _vm[j].set_state(STOP); }
+            return -1;
+        }
+        tid.push(t);
+    }
+    Pipe *p = new Pipe;
+    p->n   = n;
+    p->stg = new Stage[n];
+    p->lnk = new int[n + 1];
+    for (int i = 0; i <= n; i++) {
+        _link.push(new Link(E4_PIPE_DEPTH, VM::BATCH));
+        p->lnk[i] = _link.size() - 1;
+    }
+    _pipe.push(p);
+    int id = _pipe.size() - 1;
+    for (int i = 0; i < n; i++) {
+        p->stg[i].w = w[i];
+        VM &v = _vm[tid[i]];
+        v.rs.push(id); v.rs.push(i);
+        task_start(tid[i]);
+    }
+    return id;
+}
+void pipe_put(VM &vm, int p, DU v) { _link_put(vm, _pipe[p]->lnk[0], v); }
+void pipe_close(int p)             { _link_close(_pipe[p]->lnk[0]); }
+bool pipe_get(VM &vm, int p, DU &v) {
+    int  l = _pipe[p]->lnk[_pipe[p]->n];
+    Link &k = *_link[l];
+    DU   *b;
+    int  n;
+    if (!_link_take(vm, l, b, n)) return false;
+    v = b[k.rn++];
+    if (k.rn == n) { k.rn = 0; _link_release(l); }
+    return true;
+}
+void pipe_stat(VM &vm, int p) {
+    ostringstream &fout = vm.fout;
+    Pipe &pp = *_pipe[p];
+    U32  now = millis();
+    fout << "stage word                in    batches  backlog  items/ms" << ENDL;
+    for (int i = 0; i < pp.n; i++) {
+        Stage &st = pp.stg[i];
+        U32 nin = st.nin.load();
+        U32 dt  = (st.t1 ? st.t1 : now) - st.t0;
+        fout << setw(5)  << i << ' '
+             << left << setw(12) << dict[st.w]->name << right
+             << setw(10) << nin
+             << setw(11) << st.nbat.load()
+             << setw(9)  << (_link[pp.lnk[i]]->npub.load() - nin)
+             << setw(10) << (st.t0 ? nin / (dt ? dt : 1) : 0)
+             << ENDL;
+    }
+}
+///==================================================================
+///
+///> Timer wheel - 1ms ticks over TMR_SLOTS slots
+///
+/// Note: a pool VM in ms parks until the timer thread wakes it, so a
+///       sleeping task holds no worker. after and every run a word on
+///       a pool VM when due, periodic timers rearm from their due time
+///       (not from when they ran) so they do not drift. The thread
+///       sleeps until the next tick or the earliest due time within
+///       the current tick, and idles while no timer is pending.
+///
+struct Timer {
+    U64    due;                                  ///< due time, usec since _t0
+    U32    period;                               ///< every, in ms, 0=once
+    int    vid;                                  ///< VM asleep, or -1
+    IU     w;                                    ///< word to run
+    int    hid;                                  ///< handle for cancel
+    size_t at() { return (size_t)(due / 1000); } ///< due tick
+};
+const int   TMR_SLOTS = 256;
+const int   TMR_KEY   = LNK_KEY + 2 * FD<Link*>::BSZ * FD<Link*>::NBLK;
+const U32   JIT_US[]  = { 50, 100, 200, 500, 1000, 2000, 5000 }; ///< histogram bounds
+const int   JIT_SZ    = sizeof(JIT_US) / sizeof(U32) + 1;
+FV<Timer>   _wheel[TMR_SLOTS];                   ///< pending timers by slot
+size_t      _tick = 0;                           ///< first tick not yet handled, timer thread only
+int         _ntmr = 0;                           ///< # of pending timers
+int         _nhid = 0;                           ///< last handle issued
+bool        _tmo[E4_VM_POOL_SZ];                 ///< VM's sleep is over (VM::tsk)
+U64         _tdue[E4_VM_POOL_SZ];                ///< due time of a timed word
+IU          _tw[E4_VM_POOL_SZ];                  ///< timed word to run
+atomic<U32> _jit[JIT_SZ];                        ///< wakeup lateness histogram
+atomic<U32> _jmax { 0 };                         ///< worst lateness in usec
+atomic<U32> _tmiss { 0 };                        ///< firings skipped, pool full
+const auto  _t0 = chrono::steady_clock::now();   ///< tick 0
+
+U64 _us() {                                      ///< usec since _t0
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now() - _t0).count();
+}
+void _jitter(U32 us) {                           ///< add a wakeup to histogram
+    int i = 0;
+    while (i < JIT_SZ - 1 && us >= JIT_US[i]) i++;
+    _jit[i]++;
+    U32 m = _jmax.load();
+    while (us > m && !_jmax.compare_exchange_weak(m, us));
+}
+int _timer_add(U64 due, int vid, IU w, U32 period) {
+    Timer t;
+    t.due    = due;
+    t.period = period;
+    t.vid    = vid;
+    t.w      = w;
+    GUARD(_tmr);
+    t.hid = ++_nhid;
+    _wheel[t.at() % TMR_SLOTS].push(t);
+    if (_ntmr++ == 0) NOTIFY(_cv_tmr);           /// * wake idle timer thread
+    return t.hid;
+}
+void _timed_run(VM &vm, Code &c) {               ///< body of after/every VMs
+    _jitter((U32)(_us() - _tdue[vm.id]));
+    dict[_tw[vm.id]]->nest(vm);
+    vm.xp = NULL;                                /// * nobody collects it
+}
+Code _timed(_timed_run);
+
+void _fire(Timer &t) {
+    if (t.vid >= 0) {                            /// * end a VM's sleep
+        GUARD(VM::tsk);
+        _tmo[t.vid] = true;
+        _wake(TMR_KEY + t.vid);
+        NOTIFY_ALL(VM::cv_tsk);
+        return;
+    }
+    int v = _fork(&_timed);
+    if (!v) { _tmiss++; return; }
+    _tdue[v] = t.due;
+    _tw[v]   = t.w;
+    task_start(v);
+}
+///
+///> take due timers off slot k into fire, rearm periodic ones (_tmr locked)
+///
+void _scan(size_t k, U64 now, U64 &next, FV<Timer> &fire) {
+    FV<Timer> &s = _wheel[k % TMR_SLOTS];
+    for (int i = 0; i < (int)s.size(); ) {
+        Timer &t = s[i];
+        if (t.due > now) {                       /// * later turn, or later in tick
+            if (t.at() == k && t.due < next) next = t.due;
+            i++; continue;
+        }
+        fire.push(t);
+        if (!t.period) {                         /// * once, remove
+            t = s.back(); s.pop(); _ntmr--;
+            continue;
+        }
+        while (t.due <= now) t.due += t.period * 1000; /// * skip missed periods
+        if (t.at() % TMR_SLOTS == k % TMR_SLOTS) {
+            if (t.at() == k && t.due < next) next = t.due;
+            i++; continue;
+        }
+        _wheel[t.at() % TMR_SLOTS].push(t);
+        s[i] = s.back(); s.pop();
+    }
+}
+void _timer_loop() {
+    FV<Timer> fire;
+    while (true) {
+        U64 next;
+        {
+            XLOCK(_tmr);
+            WAIT(_cv_tmr, []{ return _ntmr > 0 || _quit; });
+            if (_quit) break;
+            
+            U64    now = _us();
+            size_t k   = (size_t)(now / 1000);
+            next = (U64)(k + 1) * 1000;          /// * next tick by default
+            if (k > _tick + TMR_SLOTS) _tick = k - TMR_SLOTS; /// * one turn covers all
+            while (_tick < k) _scan(_tick++, now, next, fire);
+            _scan(k, now, next, fire);           /// * current tick, partly gone
+        }
+        for (Timer &t : fire) _fire(t);
+        fire.clear();
+        this_thread::sleep_until(_t0 + chrono::microseconds(next));
+    }
+}
+int t_timer(IU w, U32 ms, U32 period) {
+    return _timer_add(_us() + (U64)ms * 1000, -1, w, period);
+}
+void t_cancel(int h) {
+    GUARD(_tmr);
+    for (auto &s : _wheel) {
+        for (int i = 0; i < (int)s.size(); i++) {
+            if (s[i].hid != h) continue;
+            s[i] = s.back(); s.pop(); _ntmr--;
+            return;
+        }
+    }
+}
+void t_jitter(VM &vm) {                          ///< show and reset histogram
+    ostringstream &fout = vm.fout;
+    for (int i = 0; i < JIT_SZ; i++) {
+        if (i < JIT_SZ - 1) fout << "   <" << setw(4) << JIT_US[i] << "us";
+        else                fout << "  >=" << setw(4) << JIT_US[i - 1] << "us";
+    }
+    fout << "  max(us) missed" << ENDL;
+    for (int i = 0; i < JIT_SZ; i++) fout << setw(10) << _jit[i].exchange(0);
+    fout << setw(10) << _jmax.exchange(0) << setw(7) << _tmiss.exchange(0) << ENDL;
 }
+#if DO_LOCKSTAT
+///
+///> mutex and condition variable wait counters, see LMutex
+///
+extern MUTEX sink;                               ///< output, in ceforth_sys.cpp
+void t_locks(VM &vm) {
+    struct Row { const char *nm; LStat st; };
+    Row r[] = {                                  ///< a cv after its mutex
+        { "VM::tsk",    {} }, { "VM::cv_tsk", {} },
+        { "VM::io",     {} }, { "VM::cv_io",  {} },
+        { "_evt",       {} }, { "_cv_evt",    {} },
+        { "_tmr",       {} }, { "_cv_tmr",    {} },
+        { "sink",       {} }
+    };
+    MUTEX    *m[] = { &VM::tsk, &VM::io, &_evt, &_tmr, &sink };
+    COND_VAR *c[] = { &VM::cv_tsk, &VM::cv_io, &_cv_evt, &_cv_tmr, NULL };
+    for (int i = 0; i < 5; i++) {                /// * copy under the lock
+        GUARD(*m[i]);
+        r[2 * i].st = m[i]->st;
+        if (c[i]) r[2 * i + 1].st = c[i]->st;
+    }
+    ostringstream &fout = vm.fout;
+    fout << setbase(10) << setfill(' ') << ENDL;
+    fout << "  lock/cv     acquired/waits     blocked   wait(us)    max(us)  spurious" << ENDL;
+    for (auto &x : r) {
+        if (!x.st.n) continue;
+        fout << "  " << left << setw(12) << x.nm << right
+             << setw(15) << x.st.n    << setw(12) << x.st.busy
+             << setw(11) << x.st.ns / 1000 << setw(11) << x.st.max / 1000
+             << setw(10) << x.st.spur << ENDL;
+    }
+    fout << setbase(*vm.base);
+}
+#endif // DO_LOCKSTAT
 ///==================================================================
 ///
 ///> VM methods
 ///
 void VM::set_state(vm_state st) {
-    GUARD(tsk);
     state = st;
-    NOTIFY(cv_tsk);
+    _notify(*this);                               /// * waiters on this VM, if any
 }
 void VM::join(int tid) {
     VM &vm = vm_get(tid);
     VM_LOG(this, ">> joining VM%d", vm.id);
-    {
-        XLOCK(tsk);
-        WAIT(cv_tsk, [&vm]{ return vm.state==STOP; });
-        NOTIFY(cv_tsk);
-    }
+    _wait_vm(*this, vm, [&vm]{ return vm.state==STOP; }, []{});
     VM_LOG(this, ">> VM%d joint", vm.id);
 }
+void VM::yield() {
+#if DO_COROUTINE
+    if (live) { swapcontext(ctx, host); return; } /// * back to worker
+#endif // DO_COROUTINE
+    this_thread::yield();
+}
+void VM::preempt() {
+    fuel = quantum ? quantum : 0x7fffffff;
+#if DO_COROUTINE
+    if (live && quantum) swapcontext(ctx, host);  /// * requeued behind ready VMs
+#endif // DO_COROUTINE
+}
+void VM::sleep(U32 ms) {
+#if DO_COROUTINE
+    if (live && ms) {                             /// * free worker while waiting
+        { GUARD(tsk); _tmo[id] = false; }
+        U64 due = _us() + (U64)ms * 1000;
+        _timer_add(due, id, 0, 0);
+        _wait(*this, TMR_KEY + id, [this]{ return _tmo[id]; }, []{});
+        _jitter(_us() - due);
+        return;
+    }
+#endif // DO_COROUTINE
+    delay(ms);
+}
 ///
 ///> hard copying data stacks, behaves like a message queue
 ///
 void VM::_ss_dup(VM &dst, VM &src, int n) {
+    FV<DU> &ss = src.ss;
+    if (n <= 0 || (int)ss.size() < n) return;     /// * src stack underflow
+    
+    auto p = ss.end() - (n - 1);                  ///< v1..vn-1, vn is TOS
     dst.ss.push(dst.tos);                         /// * push dest TOS
+    dst.ss.insert(dst.ss.end(), p, ss.end());     /// * pass v1..vn-1 in one move
     dst.tos = src.tos;                            /// * set dest TOS
-    src.tos = src.ss[-n];                         /// * set src TOS
-    for (int i = n - 1; i > 0; --i) {
-        dst.ss.push(src.ss[-i]);                  /// * passing stack elements
-    }
-    src.ss.erase(src.ss.end() - n);               /// * pop src by n items
+    src.tos = *(p - 1);                           /// * set src TOS
+    ss.erase(p - 1, ss.end());                    /// * pop src by n items
 }
 void VM::reset(IU w, vm_state st) {
     rs.clear();
     ss.clear();
     tos        = -DU1;
     wp         = w;                               /// * task word
+    xp         = NULL;
     *base      = 10;                              /// * default decimal
     state      = st;
     compile    = false;
+    quantum    = E4_QUANTUM;
+    fuel       = quantum;
+    grain      = 0;
+    cpu        = -1;
 }
 void VM::stop() { set_state(STOP); }              /// * and release lock
 ///
+///> take a VM waiting in recv, RECV => MSG, one sender only
+///
+bool _claim(VM &vm) {
+    vm_state s = RECV;
+    return vm.state.compare_exchange_strong(s, MSG);
+}
+///
 ///> send to destination VM's stack (blocking)
 ///
+/// Note: when launched with -np, tid >= E4_VM_POOL_SZ addresses
+///       VM (tid % E4_VM_POOL_SZ) of node (tid / E4_VM_POOL_SZ - 1)
+///
 void VM::send(int tid, int n) {                   ///< ( v1 v2 .. vn -- )
+#if DO_MPI
+    if (tid >= E4_VM_POOL_SZ) {
+        if (tid / E4_VM_POOL_SZ - 1 != _node) {   /// * VM on another node
+            _mpi_send(*this, tid, n);
+            return;
+        }
+        tid %= E4_VM_POOL_SZ;                     /// * our own, deliver locally
+    }
+#endif // DO_MPI
     VM& vm = vm_get(tid);                         ///< destination VM
-    
-    XLOCK(tsk);
-    WAIT(cv_tsk, [vm]{ return vm.state==HOLD || _quit; });
 
-    if (_quit) return;                            /// * nothing to do, bail
+    bool ok = false;
+    TRC_T0;
+    _wait_vm(*this, vm, [&vm]{ return _claim(vm); }, [&ok]{ ok = !_quit; });
+    TRC(TRC_SEND, id, tid);
+    if (!ok) return;                              /// * quit while waiting
 
-    VM_LOG(&vm, ">> sending %d items to VM%d.%d", n, tid, vm.state);
+    VM_LOG(&vm, ">> sending %d items to VM%d.%d", n, tid, (int)vm.state);
     _ss_dup(vm, *this, n);                        /// * pass n params as a msg queue
-    vm.state = NEST;                              /// * unblock target task
-
-    NOTIFY(cv_tsk);
+    vm.set_state(NEST);                           /// * unblock target task
 }
 ///
 ///> receive from source VM's stack (blocking)
 ///
 void VM::recv() {                                 ///< ( -- v1 v2 .. vn )
     vm_state st = state;                          ///< keep current VM state
-    {
-        GUARD(tsk);                               /// * lock tasker
-        state = HOLD;                             /// * pending state for message
-        NOTIFY(cv_tsk);
-    }
+    set_state(RECV);                              /// * pending state for message
     VM_LOG(this, ">> waiting");
-    {
-        XLOCK(tsk);
-        WAIT(cv_tsk, [this]{ return state!=HOLD || _quit; }); /// * block until msg arrive
-        state = st;                                /// * restore VM state
-    
-        NOTIFY(cv_tsk);
-    }
+    TRC_T0;
+    _wait_vm(*this, *this,                        /// * block until msg arrive
+          [this]{ vm_state s = state; return s!=RECV && s!=MSG; },
+          [this, st]{ state = st; });             /// * restore VM state
+    TRC(TRC_RECV, id, 0);
     VM_LOG(this, ">> received => state=%d", st);
 }
 ///
@@ -244,33 +1446,247 @@ void VM::bcast(int n) {
 ///
 void VM::pull(int tid, int n) {
     VM& vm = vm_get(tid);                         ///< source VM
-    
-    XLOCK(tsk);
-    WAIT(cv_tsk, [vm]{ return vm.state==STOP || _quit; });
-    
-    if (!_quit) {
-        _ss_dup(*this, vm, n);                    /// * retrieve from completed task
-        printf(">> pulled %d items from VM%d.%d\n", n, vm.id, vm.state);
-    }
-    
-    NOTIFY(cv_tsk);
+
+    TRC_T0;
+    _wait_vm(*this, vm, [&vm]{ return vm.state==STOP; }, [&]{
+        if (!_quit) _ss_dup(*this, vm, n);        /// * retrieve from completed task
+    });
+    TRC(TRC_PULL, id, tid);
+}
+///
+///> futures - wait for a spawned task, take its n results, release its VM
+///
+void VM::await(int tid, int n) {
+    VM& vm = vm_get(tid);                         ///< future's VM
+
+    _wait_vm(*this, vm, [&vm]{ return vm.state==STOP; }, [&]{
+        if (_quit) return;
+        _ss_dup(*this, vm, n);                    /// * results onto our stack
+        vm.xp = NULL;                             /// * VM free for reuse
+    });
 }
 ///
 ///> IO control (can use atomic _io after C++20)
 ///
 /// Note: after C++20, _io can be atomic.wait
+#if DO_TRACE
+#define IO_HELD()  { _io_t0 = _trc_at(); _io_vid = id; }  /** hold starts */
+#else  // !DO_TRACE
+#define IO_HELD()
+#endif // DO_TRACE
 void VM::io_lock() {
+#if DO_COROUTINE
+    while (live) {                                /// * spin on green thread
+        {
+            GUARD(io);
+            if (!io_busy) { io_busy = true; IO_HELD(); return; }
+        }
+        yield();
+    }
+#endif // DO_COROUTINE
     XLOCK(io);                                    ///< wait for IO
     WAIT(cv_io, []{ return !io_busy; });
     
     io_busy = true;                               /// * lock
+    IO_HELD();
     
     NOTIFY(cv_io);
 }
 
 void VM::io_unlock() {
     GUARD(io);
+#if DO_TRACE
+    if (io_busy) _trc(TRC_LOCK, _io_vid, _io_t0, 0);
+#endif // DO_TRACE
     io_busy = false;                              /// * unlock
     NOTIFY(cv_io);
 }
 #endif // DO_MULTITASK
+///============================================================
+///
+///> Multi-process transport - send/recv between eforth processes
+///
+/// Note: launched with -np N, each process (a node) gets an inbox ring
+///       in one POSIX shared memory segment. A sender posts onto the
+///       inbox of the target node, and a proxy thread there hands the
+///       message to its VM just as a local send would, so the message
+///       words are unchanged. Rank discovery is by environment,
+///       E4_MPI (segment name), E4_NODES, and E4_NODE (set by -np)
+///
+#if DO_MPI
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <cstdlib>
+
+static_assert((E4_MPI_RING & (E4_MPI_RING - 1)) == 0, "E4_MPI_RING must be a power of 2");
+static_assert(atomic<U32>::is_always_lock_free, "shared memory needs lock-free atomics");
+
+///
+///> slot seq is kept less its slot index j, so the zero filled
+///  segment reads as Vyukov's initial seq=j, i.e. all slots empty
+///
+struct Slot {                                     ///< one message
+    atomic<U32> seq;                              ///< Vyukov sequence less slot index
+    U16         vid;                              ///< target VM on the node
+    U16         n;                                ///< number of cells
+    DU          v[E4_MPI_MSG];                    ///< v1 .. vn
+};
+struct Inbox {                                    ///< MPSC ring of a node
+    alignas(64) atomic<U32> tail;                 ///< next slot to claim, senders
+    alignas(64) atomic<U32> head;                 ///< next slot to take, proxy
+    atomic<U32> bell;                             ///< bumped per post, futex word
+    atomic<U32> nwait;                            ///< proxy asleep on bell
+    Slot        slot[E4_MPI_RING];
+};
+struct Msg {                                      ///< a message held by the proxy
+    U16         n;
+    DU          v[E4_MPI_MSG];
+};
+Inbox      *_inbox = NULL;                        ///< shared, one per node
+THREAD     _proxy;                                ///< delivers inbound messages
+queue<Msg> _held[E4_VM_POOL_SZ];                  ///< proxy only, for VMs not in recv
+int        _nheld = 0;                            ///< messages held, all VMs
+///
+///> futex on shared memory, across processes
+///
+void _bell_wait(atomic<U32> &a, U32 v, long ns=100000000) {
+    struct timespec t = { 0, ns };               ///< 100ms default, to notice _quit
+    syscall(SYS_futex, reinterpret_cast<int*>(&a), FUTEX_WAIT, (int)v, &t, NULL, 0);
+}
+void _bell_ring(atomic<U32> &a) {
+    syscall(SYS_futex, reinterpret_cast<int*>(&a), FUTEX_WAKE, 0x7fffffff, NULL, NULL, 0);
+}
+int t_node()  { return _node;  }
+int t_nodes() { return _nodes; }
+///
+///> hand a message to local VM vm if it is in recv, without waiting
+///
+bool _deliver(VM &vm, DU *v, int n) {
+    if (!_claim(vm)) return false;                /// * busy, caller holds it
+
+    if (n > 0) {
+        vm.ss.push(vm.tos);                       /// * as _ss_dup does
+        vm.ss.insert(vm.ss.end(), v, v + n - 1);
+        vm.tos = v[n - 1];
+    }
+    vm.set_state(NEST);                           /// * unblock target task
+    return true;
+}
+///
+///> drain the inbox, holding messages per VM until it is in recv
+///
+/// Note: a VM that is not receiving only stalls its own messages. Up to
+///       E4_MPI_RING are held for it, then the inbox stops draining and
+///       the ring pushes back on senders. recv does not ring the bell,
+///       so while messages are held the proxy polls every 1ms
+///
+void _proxy_loop() {
+    Inbox &ib = _inbox[_node];
+    while (!_quit) {
+        for (int i = 0; _nheld && i < E4_VM_POOL_SZ; i++) {
+            queue<Msg> &q = _held[i];             /// * oldest first, per VM
+            while (!q.empty() && _deliver(vm_get(i), q.front().v, q.front().n)) {
+                q.pop();
+                _nheld--;
+            }
+        }
+        U32  pos = ib.head.load(memory_order_relaxed);
+        U32  j   = pos & (E4_MPI_RING - 1);
+        Slot &s  = ib.slot[j];
+        bool in  = s.seq.load(memory_order_acquire) + j == pos + 1;
+        if (in && _held[s.vid].size() < E4_MPI_RING) {
+            queue<Msg> &q = _held[s.vid];
+            if (!q.empty() || !_deliver(vm_get(s.vid), s.v, s.n)) {
+                Msg m;                            /// * keep order behind held ones
+                m.n = s.n;
+                copy(s.v, s.v + s.n, m.v);
+                q.push(m);
+                _nheld++;
+            }
+            s.seq.store(pos + E4_MPI_RING - j, memory_order_release);  /// * slot free
+            ib.head.store(pos + 1, memory_order_relaxed);
+            continue;
+        }
+        U32 b = ib.bell.load();                   /// * empty or full, sleep on the bell
+        ib.nwait++;
+        if (in || s.seq.load() + j != pos + 1) _bell_wait(ib.bell, b, _nheld ? 1000000 : 100000000);
+        ib.nwait--;
+    }
+}
+///
+///> node side - attach to inboxes when started by the launcher
+///
+/// Note: whichever node comes first creates the segment, ftruncate
+///       zero fills it, and a zero seq is an empty slot (see Slot),
+///       so no node has to initialize it. The launcher unlinks it
+///
+void _mpi_init() {
+    const char *nm = getenv("E4_MPI");
+    const char *np = getenv("E4_NODES");
+    const char *r  = getenv("E4_NODE");
+    if (!nm || !np || !r) return;                 /// * single process
+
+    int    n  = atoi(np);
+    size_t sz = sizeof(Inbox) * n;
+    int    fd = shm_open(nm, O_CREAT | O_RDWR, 0600);
+    void   *p = (fd < 0 || ftruncate(fd, sz)) ? MAP_FAILED
+        : mmap(NULL, sz, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (fd >= 0) close(fd);
+    if (p == MAP_FAILED) {
+        printf("node %s: %s attach failed\n", r, nm);
+        return;
+    }
+    _inbox = (Inbox*)p;
+    _nodes = n;
+    _node  = atoi(r);
+    _proxy = THREAD(_proxy_loop);
+    printf("node %d of %d attached to %s\n", _node, _nodes, nm);
+}
+void _mpi_stop() {
+    if (!_inbox) return;
+    _bell_ring(_inbox[_node].bell);               /// * _quit is set, wake proxy
+    _proxy.join();
+    munmap(_inbox, sizeof(Inbox) * _nodes);
+    _inbox = NULL;
+}
+///
+///> post n items onto the inbox of the node owning tid
+///
+void _mpi_send(VM &vm, int tid, int n) {
+    int k = tid / E4_VM_POOL_SZ - 1;              ///< target node
+    if (!_inbox || k >= _nodes) { pstr(vm, "  ?node", CR); return; }
+    if (n < 0 || n > E4_MPI_MSG || (int)vm.ss.size() < n) {
+        pstr(vm, "  ?message size", CR); return;
+    }
+    Inbox &ib  = _inbox[k];
+    U32   pos  = ib.tail.load(memory_order_relaxed);
+    U32   j;
+    Slot  *s;
+    while (true) {                                /// * claim a slot
+        j = pos & (E4_MPI_RING - 1);
+        s = &ib.slot[j];
+        int d = (int)(s->seq.load(memory_order_acquire) + j - pos);
+        if (d == 0) {
+            if (ib.tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+        }
+        else if (d < 0) {                         /// * inbox full, wait for proxy
+            if (_quit) return;
+            vm.yield();
+            pos = ib.tail.load(memory_order_relaxed);
+        }
+        else pos = ib.tail.load(memory_order_relaxed);
+    }
+    s->vid = (U16)(tid % E4_VM_POOL_SZ);
+    s->n   = (U16)n;
+    for (int i = n - 1; i >= 0; i--) {            /// * vn is TOS
+        s->v[i] = vm.tos;
+        vm.tos  = vm.ss.pop();
+    }
+    s->seq.store(pos + 1 - j, memory_order_release);  /// * publish
+    ib.bell++;                                    /// * then ring the bell
+    if (ib.nwait.load()) _bell_ring(ib.bell);
+}
+#else  // !DO_MPI
+int  t_node()           { return 0; }
+int  t_nodes()          { return 1; }
+#endif // DO_MPI
@@ -11,14 +11,34 @@
 #define USE_FLOAT       0               /**< support floating point */
 #define DO_WASM         __EMSCRIPTEN__  /**< for WASM output        */
 #define DO_MULTITASK    0               /**< multitasking/pthread   */
-#define E4_VM_POOL_SZ   8               /**< # of threads in pool   */
+#define DO_COROUTINE    1               /**< green-thread VMs       */
+#define E4_VM_POOL_SZ   8               /**< # of VMs in pool       */
+#define E4_THREAD_SZ    0               /**< # of workers, 0=auto   */
+#define E4_VM_STACK_SZ  (256*1024)      /**< green-thread stack size*/
+#define E4_CPU_PLACE    3               /**< 1=compact,2=scatter,3=physical */
+#define E4_PIPE_DEPTH   4               /**< batches between stages */
+#define E4_QUANTUM      10000           /**< words per turn, 0=no preempt */
+#define DO_MPI          1               /**< send/recv across processes */
+#define E4_MPI_RING     256             /**< messages per node inbox */
+#define E4_MPI_MSG      16              /**< cells per message      */
+#define DO_LOCKSTAT     0               /**< mutex/cv wait counters */
+#define DO_PROFILE      0               /**< per-word profiler in nest */
+#define DO_SAMPLE       0               /**< SIGPROF sampling profiler */
+#define E4_SMP_DEPTH    32              /**< shadow stack depth     */
+#define E4_SMP_SLOTS    4096            /**< distinct sampled stacks */
+#define DO_PERF         0               /**< perf map/jitdump of primitives */
+#define DO_PMC          0               /**< perf_event_open counter words */
+#define DO_TRACE        0               /**< Chrome trace of tasks  */
+#define E4_TRC_EVENTS   65536           /**< trace events per thread */
 //@}
 ///
 ///@name Logical units (instead of physical) for type check and portability
 ///@{
+typedef uint64_t        U64;   ///< unsigned 64-bit integer
 typedef uint32_t        U32;   ///< unsigned 32-bit integer
 typedef int32_t         S32;   ///< signed 32-bit integer
 typedef uint16_t        U16;   ///< unsigned 16-bit integer
+typedef int16_t         S16;   ///< signed 16-bit integer
 typedef uint8_t         U8;    ///< byte, unsigned character
 typedef uintptr_t       UFP;   ///< function pointer as integer
 typedef uint16_t        IU;    ///< instruction pointer unit
@@ -81,7 +101,7 @@ typedef int32_t         DU;
 // #define ALIGNAS         alignas(std::hardware_destructive_interference_size) C++17 but didn't work
 #define ALIGNAS         alignas(64)
 #define STRLEN(s)       (ALIGN(strlen(s)+1))  /** calculate string size with alignment */
-#define CALLBACK        fout_cb((int)fout.str().length(), fout.str().c_str()); fout.str("")
+#define CALLBACK        fout_flush(fout)      /** send a VM's buffered output to sink */
 #define FLUSH           flush; CALLBACK
 #define ENDL            endl; CALLBACK
 ///@}
@@ -114,6 +134,41 @@ typedef int32_t         DU;
     #define DALIGN(sz)      (sz)
 
 #endif // (ARDUINO || ESP32)
+
+#if DO_COROUTINE && (!DO_MULTITASK || DO_WASM || (ARDUINO || ESP32) || (_WIN32 || _WIN64))
+    #undef  DO_COROUTINE                /// * needs pthread and ucontext
+    #define DO_COROUTINE    0
+#endif // DO_COROUTINE
+
+#if DO_MPI && (!DO_MULTITASK || DO_WASM || !defined(__linux__))
+    #undef  DO_MPI                      /// * needs POSIX shm and futex
+    #define DO_MPI          0
+#endif // DO_MPI
+
+#if DO_LOCKSTAT && !DO_MULTITASK
+    #undef  DO_LOCKSTAT                 /// * counts the task mutexes
+    #define DO_LOCKSTAT     0
+#endif // DO_LOCKSTAT
+
+#if DO_TRACE && (!DO_MULTITASK || DO_WASM || (ARDUINO || ESP32) || (_WIN32 || _WIN64))
+    #undef  DO_TRACE                    /// * traces the thread pool
+    #define DO_TRACE        0
+#endif // DO_TRACE
+
+#if DO_PERF && (DO_WASM || !defined(__linux__))
+    #undef  DO_PERF                     /// * perf is Linux only
+    #define DO_PERF         0
+#endif // DO_PERF
+
+#if DO_PMC && (DO_WASM || !defined(__linux__))
+    #undef  DO_PMC                      /// * needs perf_event_open
+    #define DO_PMC          0
+#endif // DO_PMC
+
+#if DO_SAMPLE && (DO_WASM || (ARDUINO || ESP32) || (_WIN32 || _WIN64))
+    #undef  DO_SAMPLE                   /// * needs setitimer and SIGPROF
+    #define DO_SAMPLE       0
+#endif // DO_SAMPLE
 ///@}
 ///@name Logging supporting macros
 ///@{
@@ -143,11 +198,11 @@ typedef int32_t         DU;
 #if DO_WASM || (ESP32 || ARDUINO) || (_WIN32 || _WIN64)
 #define VM_LOG(vm, fmt, ...)                   \
     printf("[%02d.%d] " fmt "\n",              \
-           (vm)->id, (vm)->state, ##__VA_ARGS__)
+           (vm)->id, (int)(vm)->state, ##__VA_ARGS__)
 #else // !(DO_WASM || (ESP32 || ARDUINO) || (_WIN32 || _WIN64))
 #define VM_LOG(vm, fmt, ...)                   \
     printf("\e[%dm[%02d.%d] " fmt "\e[0m\n",   \
-           ((vm)->id&7) ? 38-((vm)->id&7) : 37, (vm)->id, (vm)->state, ##__VA_ARGS__)
+           ((vm)->id&7) ? 38-((vm)->id&7) : 37, (vm)->id, (int)(vm)->state, ##__VA_ARGS__)
 #endif // DO_WASM || (ESP32 || ARDUINO) || (_WIN32 || _WIN64)
 
 #else  // !(CC_DEBUG > 1)
@@ -0,0 +1,31 @@
+\
+\ contention - k tasks bump one shared counter N times each
+\   +!       plain, loses updates under contention
+\   atomic+! lock-free, one RMW per update
+\   cas      compare-and-swap retry loop
+\   lock     lock +! unlock, the IO mutex
+\
+1000000 constant N
+variable cnt
+variable #k
+: plain  ( -- ) N 1- for 1 cnt +! next ;
+: fadd   ( -- ) N 1- for 1 cnt atomic+! next ;
+: cas1   ( -- ) begin cnt atomic@ dup 1+ cnt cas until ;
+: casn   ( -- ) N 1- for cas1 next ;
+: locked ( -- ) N 1- for lock 1 cnt +! unlock next ;
+: fork ( xt k -- f1 .. fk ) 1- for dup spawn swap next drop ;
+: reap ( f1 .. fk k -- ) 1- for 0 swap await next ;
+: run ( xt k -- )
+  #k ! 0 cnt !
+  clock negate swap
+  #k @ fork #k @ reap
+  clock +
+  ." k=" #k ? ." ms=" dup .
+  ." ns/op=" 1000000 #k @ N * */ 1 max .
+  ." lost=" #k @ N * cnt @ - . cr ;
+: sweep ( xt -- ) 4 1 do dup i run loop drop ;
+.( plain +! ) cr    ' plain  sweep
+.( atomic+! ) cr    ' fadd   sweep
+.( cas loop ) cr    ' casn   sweep
+.( lock +! unlock ) cr ' locked sweep
+bye
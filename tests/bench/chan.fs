@@ -0,0 +1,26 @@
+\
+\ channel throughput - k producers and k consumers on one bounded channel
+\   compare core counts by rebuilding with E4_THREAD_SZ=1,2,4...
+\   or by running under taskset -c
+\
+100000 constant N                   \ items per producer
+64 channel ch                       \ bounded, producers block when full
+variable sum
+variable #k
+: prod ( -- ) N 1- for i 1000 mod ch chan! next ;   \ sum fits a 32-bit cell
+: cons ( -- ) 0 N 1- for ch chan@ + next lock sum +! unlock ;
+' prod constant xp
+' cons constant xc
+: fork ( xt k -- f1 .. fk ) 1- for dup spawn swap next drop ;
+: reap ( f1 .. fk k -- ) 1- for 0 swap await next ;
+: run ( k -- )
+  #k ! 0 sum !
+  clock negate
+  xc #k @ fork xp #k @ fork
+  #k @ 2* reap
+  clock +
+  ." pairs=" #k ? ." ms=" dup .
+  ." items/ms=" #k @ N * swap 1 max / .
+  ." sum=" sum ? ." expect=" #k @ N 1000 / * 499500 * . cr ;
+1 run 2 run 3 run
+bye
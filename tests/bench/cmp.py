@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+#
+# cross-version comparison - run the same tests/bench/cmp_*.fs on src, 40x and 50x,
+#                            report wall time and peak RSS of each
+#
+#   usage: python3 tests/bench/cmp.py [-e name=exe ..] [-n runs] [-s dispatch,..] [-o out.json]
+#
+#   40x has no clock and 50x has no 2*, so the workloads use only words
+#   common to all versions and are timed from outside, per process; the
+#   startup workload (bye only) shows the fixed cost included in each.
+#   Peak RSS is ru_maxrss of the engine process, in KB, Linux only.
+#
+#   build the engines with make exe 40x 50x (or make bench-cmp)
+#
+import argparse, ctypes, json, os, signal, subprocess, sys, tempfile, threading, time
+
+from msg import HERE
+
+ENGINE = [('src', 'eforth'), ('40x', 'ceforth40x'), ('50x', 'ceforth50x')]
+SUITE  = ['startup', 'dispatch', 'calls', 'arith', 'stack', 'mem', 'str', 'compile']
+
+def compile_src(n=100, m=20):          # fewer, longer definitions than vm.py, and not
+    body = ' 1 drop' * m                # chained, for the 400-word dictionary and
+    src  = [': w%d ( -- )%s ;' % (i, body) for i in range(n)]   # short rs of 40x/50x
+    return '\n'.join(src) + '\nbye\n'
+
+def source(name):
+    if name == 'startup': return 'bye\n'
+    if name == 'compile': return compile_src()
+    with open(os.path.join(HERE, 'cmp_%s.fs' % name)) as f:
+        return f.read()
+
+def subreaper():                       # orphans are reparented to us, see measure
+    libc = ctypes.CDLL(None, use_errno=True)
+    if libc.prctl(36, 1, 0, 0, 0):     # PR_SET_CHILD_SUBREAPER
+        sys.exit('prctl: %s' % os.strerror(ctypes.get_errno()))
+
+def measure(exe, fs, timeout):         # => (wall ms, peak RSS KB, exit status)
+    #
+    # a child forked from python inherits its RSS high-water mark, so the
+    # engine is started in the background by sh (small), which then execs
+    # echo so it never reaps it, and the orphan is reaped here by wait4,
+    # which gives the engine's own ru_maxrss
+    #
+    t0  = time.perf_counter()
+    pid = int(subprocess.run(
+        ['sh', '-c', '"$0" < "$1" > /dev/null 2>&1 & exec echo $!', exe, fs],
+        capture_output=True, text=True, check=True).stdout)
+    tm  = threading.Timer(timeout, os.kill, (pid, signal.SIGKILL))
+    tm.daemon = True
+    tm.start()
+    _, st, ru = os.wait4(pid, 0)
+    ms  = (time.perf_counter() - t0) * 1000.0
+    tm.cancel()
+    if os.WIFSIGNALED(st) and os.WTERMSIG(st) == signal.SIGKILL:
+        raise subprocess.TimeoutExpired(exe, timeout)
+    return ms, ru.ru_maxrss, os.waitstatus_to_exitcode(st)
+
+def stat(ms, kb):
+    ms = sorted(ms)
+    return {
+        'min':    round(ms[0], 1),
+        'median': round(ms[len(ms) // 2], 1),
+        'rss_kb': max(kb),
+    }
+
+def table(rpt):                        # text table, time in ms / peak RSS in MB
+    eng = list(rpt['engine'])
+    hdr = '%-10s' % 'workload' + ''.join('%18s' % e for e in eng)
+    out = [hdr, '-' * len(hdr)]
+    for w in rpt['suite']:
+        row = '%-10s' % w
+        for e in eng:
+            r = rpt['bench'][e][w]
+            row += '%18s' % ('%.1fms %.1fMB' % (r['median'], r['rss_kb'] / 1024.0)
+                             if r else 'fail')
+        out.append(row)
+    return '\n'.join(out)
+
+def main():
+    ap = argparse.ArgumentParser(description='eForth cross-version comparison')
+    ap.add_argument('-e', '--engine', action='append',
+                    help='name=exe, repeatable, default src, 40x, 50x in tests/')
+    ap.add_argument('-n', '--runs', type=int, default=3, help='runs of each workload')
+    ap.add_argument('-o', '--out', help='also write JSON here')
+    ap.add_argument('-t', '--timeout', type=int, default=300, help='seconds per run')
+    ap.add_argument('-s', '--only', help='comma list, subset of ' + ','.join(SUITE))
+    a = ap.parse_args()
+
+    eng = ([tuple(e.split('=', 1)) for e in a.engine] if a.engine else
+           [(k, os.path.join(HERE, '..', x)) for k, x in ENGINE])
+    eng = [(k, x) for k, x in eng if os.access(x, os.X_OK) or
+           print('%s: %s not built, skipped' % (k, x), file=sys.stderr)]
+    if not eng:
+        sys.exit('no engine to run, try make exe 40x 50x')
+
+    subreaper()
+    suite = a.only.split(',') if a.only else SUITE
+    bench = {}                          # engine => workload => stat
+    for w in suite:
+        with tempfile.NamedTemporaryFile('w', suffix='.fs', delete=False) as f:
+            f.write(source(w))          # stdin of the engine
+        for k, x in eng:
+            ms, kb = [], []
+            for _ in range(a.runs):
+                try:
+                    t, m, rc = measure(x, f.name, a.timeout)
+                except subprocess.TimeoutExpired:
+                    sys.exit('%s %s: timed out after %ds' % (k, w, a.timeout))
+                if rc:
+                    print('%s %s: exit status %d' % (k, w, rc), file=sys.stderr)
+                    break
+                ms.append(t); kb.append(m)
+            bench.setdefault(k, {})[w] = stat(ms, kb) if ms else False
+        os.unlink(f.name)
+
+    rpt = {
+        'unit':   'ms, KB',
+        'time':   time.strftime('%Y-%m-%dT%H:%M:%S'),
+        'cpus':   os.cpu_count(),
+        'runs':   a.runs,
+        'engine': { k: os.path.abspath(x) for k, x in eng },
+        'suite':  suite,
+        'bench':  bench,
+    }
+    print(table(rpt))
+    if a.out:
+        with open(a.out, 'w') as f: f.write(json.dumps(rpt, indent=2) + '\n')
+
+if __name__ == '__main__':
+    main()
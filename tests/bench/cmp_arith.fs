@@ -0,0 +1,8 @@
+\
+\ cross-version workload - arithmetic, 20M rounds
+\   common words only, timed from outside by tests/bench/cmp.py
+\
+: arith1 ( -- ) 0 99999 for i 3 * 7 + 5 mod + next drop ;
+: arith  ( -- ) 199 for arith1 next ;
+arith
+bye
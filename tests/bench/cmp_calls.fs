@@ -0,0 +1,9 @@
+\
+\ cross-version workload - colon word calls, 100M
+\   common words only, timed from outside by tests/bench/cmp.py
+\
+: nop   ( -- ) ;
+: nops  ( -- ) 99999 for nop next ;
+: calls ( -- ) 999 for nops next ;
+calls
+bye
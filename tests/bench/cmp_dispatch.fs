@@ -0,0 +1,9 @@
+\
+\ cross-version workload - nested empty loops, 1G iterations
+\   common words only, timed from outside by tests/bench/cmp.py
+\
+: inner    ( -- ) 9999 for next ;
+: outer    ( -- ) 9999 for inner next ;
+: dispatch ( -- ) 9 for outer next ;
+dispatch
+bye
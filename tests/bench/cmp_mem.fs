@@ -0,0 +1,9 @@
+\
+\ cross-version workload - variable fetch and store, 10M rounds
+\   common words only, timed from outside by tests/bench/cmp.py
+\
+variable v
+: mem1 ( -- ) 99999 for i v ! v @ 1+ v ! v @ drop next ;
+: mem  ( -- ) 99 for mem1 next ;
+mem
+bye
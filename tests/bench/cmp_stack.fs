@@ -0,0 +1,8 @@
+\
+\ cross-version workload - stack shuffles, 20M rounds
+\   common words only, timed from outside by tests/bench/cmp.py
+\
+: stack1 ( -- ) 1 2 3 99999 for swap rot over drop dup drop -rot next drop drop drop ;
+: stack  ( -- ) 199 for stack1 next ;
+stack
+bye
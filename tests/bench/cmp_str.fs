@@ -0,0 +1,7 @@
+\
+\ cross-version workload - formatted output, 1M lines
+\   common words only, timed from outside by tests/bench/cmp.py
+\
+: str ( -- ) 999999 for ." hello, world " i . cr next ;
+str
+bye
@@ -0,0 +1,30 @@
+\
+\ fairness - K spinners that never wait, twice the workers
+\   with quantum 0 the first ones hog the workers and the rest starve,
+\   with a quantum each gets a turn; shows words run per task
+\   K is capped by the 7 VMs that E4_VM_POOL_SZ=8 leaves for tasks
+\
+workers 2* 7 min constant K
+: enough? ( -- ) K workers > 0= if
+  ." only " K . ." VMs for " workers . ." workers, raise E4_VM_POOL_SZ" cr then ;
+enough?
+variable #run
+create tid K allot
+: spin ( -- n ) 0 begin 1+ #run @ 0= until ;
+' spin constant xs
+: launch ( q -- )
+  1 #run !
+  K 1- for xs task dup tid i th ! over swap quantum next drop
+  K 1- for tid i th @ start next ;
+: reap ( -- mn mx )
+  0 #run ! 2147483647 0
+  K 1- for
+    tid i th @ dup join 1 swap pull
+    dup . swap over max >r min r>
+  next ;
+: run ( q -- )
+  ." quantum=" dup . launch 300 ms
+  ." loops=" reap
+  ." min/max%=" 100 rot rot */ . cr ;
+0 run 100000 run 10000 run 1000 run
+bye
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+#
+# message passing benchmarks - run tests/bench/msg_*.fs, report percentiles as JSON
+#
+#   usage: python3 tests/bench/msg.py [eforth] [-n runs] [-s pingpong,..] [-o out.json]
+#
+#   each script prints sample lines "@ name ops ms", one per timed batch;
+#   clock is in msec, so a sample is the mean usec/op over its batch and the
+#   percentiles are taken across batches (and across runs with -n)
+#
+#   needs a DO_MULTITASK=1 build of tests/eforth
+#
+import argparse, json, os, re, subprocess, sys, time
+
+HERE  = os.path.dirname(os.path.abspath(__file__))
+SUITE = ['pingpong', 'fanout', 'fanin', 'task', 'lock']
+LINE  = re.compile(r'@ (\S+) (\d+) (\d+)')
+
+def pct(v, p):                          # nearest-rank percentile of sorted v
+    return v[min(len(v) - 1, max(0, int(round(p / 100.0 * len(v) + 0.5)) - 1))]
+
+def feed(exe, src, timeout):           # run Forth source, collect samples
+    out = subprocess.run([exe], input=src, capture_output=True,
+                         text=True, timeout=timeout).stdout
+    return [(m[1], int(m[2]), int(m[3])) for m in LINE.finditer(out)]
+
+def run(exe, fs, timeout):
+    with open(fs) as f:
+        return feed(exe, f.read(), timeout)
+
+def stat(ops, ms):
+    us = sorted(1000.0 * t / n for n, t in zip(ops, ms))
+    return {
+        'samples': len(us),
+        'ops':     sum(ops),
+        'ops_per_ms': round(sum(ops) / max(1, sum(ms)), 1),
+        'min':  round(us[0], 3),
+        'p50':  round(pct(us, 50), 3),
+        'p90':  round(pct(us, 90), 3),
+        'p99':  round(pct(us, 99), 3),
+        'max':  round(us[-1], 3),
+        'mean': round(sum(us) / len(us), 3),
+    }
+
+def main():
+    ap = argparse.ArgumentParser(description='eForth message passing benchmarks')
+    ap.add_argument('exe', nargs='?', default=os.path.join(HERE, '..', 'eforth'))
+    ap.add_argument('-n', '--runs', type=int, default=1, help='runs of each script')
+    ap.add_argument('-o', '--out', help='write JSON here instead of stdout')
+    ap.add_argument('-t', '--timeout', type=int, default=300, help='seconds per script')
+    ap.add_argument('-s', '--only', help='comma list, subset of ' + ','.join(SUITE))
+    a = ap.parse_args()
+
+    bench = {}                          # name => ([ops], [ms])
+    for s in (a.only.split(',') if a.only else SUITE):
+        fs = os.path.join(HERE, 'msg_%s.fs' % s)
+        for _ in range(a.runs):
+            try:
+                smp = run(a.exe, fs, a.timeout)
+            except subprocess.TimeoutExpired:
+                sys.exit('%s: timed out after %ds' % (fs, a.timeout))
+            if not smp:
+                sys.exit('%s: no samples, is %s built with DO_MULTITASK=1?' % (fs, a.exe))
+            for name, n, t in smp:
+                b = bench.setdefault(name, ([], []))
+                b[0].append(n); b[1].append(t)
+
+    rpt = {
+        'unit':  'usec/op',
+        'time':  time.strftime('%Y-%m-%dT%H:%M:%S'),
+        'cpus':  os.cpu_count(),
+        'runs':  a.runs,
+        'bench': { k: stat(*v) for k, v in bench.items() },
+    }
+    js = json.dumps(rpt, indent=2)
+    if a.out:
+        with open(a.out, 'w') as f: f.write(js + '\n')
+    else:
+        print(js)
+
+if __name__ == '__main__':
+    main()
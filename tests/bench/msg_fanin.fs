@@ -0,0 +1,21 @@
+\
+\ message passing - many-to-one fan-in
+\   K tasks send to VM0 at once, the senders queue up on VM0's recv
+\   each sample prints "@ name ops ms", collected by tests/bench/msg.py
+\
+4    constant K                     \ senders
+20   constant R                     \ samples
+1000 constant M                     \ values from each sender per sample
+create tid K allot
+: src ( -- ) R M * 1- for i 1 0 send next ;
+' src constant xs
+: launch ( -- ) K 1- for xs task dup tid i th ! start next ;
+: sample ( -- ) M K * 1- for recv drop next ;
+: run ( -- )
+  R 1- for
+    clock negate sample clock +
+    ." @ fanin " M K * . . cr
+  next ;
+: jn ( -- ) K 1- for tid i th @ join next ;
+launch run jn
+bye
@@ -0,0 +1,22 @@
+\
+\ message passing - one-to-many fan-out
+\   VM0 sends each value to K receiving tasks in turn (bcast is not there yet)
+\   each sample prints "@ name ops ms", collected by tests/bench/msg.py
+\
+4    constant K                     \ receivers
+20   constant R                     \ samples
+1000 constant M                     \ values to each receiver per sample
+create tid K allot
+: sink ( -- ) begin recv 0< until ;
+' sink constant xs
+: launch  ( -- ) K 1- for xs task dup tid i th ! start next ;
+: scatter ( v -- ) K 1- for dup 1 tid i th @ send next drop ;
+: sample  ( -- ) M 1- for i scatter next ;
+: run ( -- )
+  R 1- for
+    clock negate sample clock +
+    ." @ fanout " M K * . . cr
+  next ;
+: jn ( -- ) K 1- for tid i th @ join next ;
+launch run -1 scatter jn
+bye
@@ -0,0 +1,20 @@
+\
+\ message passing - lock/unlock contention
+\   k tasks take and release the IO lock M times each, k=1 is uncontended
+\   each sample prints "@ name ops ms", collected by tests/bench/msg.py
+\
+20    constant R                    \ samples
+200000 constant M                   \ lock/unlock pairs per task per sample
+create tid 4 allot
+: crit ( -- ) M 1- for lock unlock next ;
+' crit constant xc
+: sample ( k -- )
+  dup 1- for xc task dup tid i th ! start next
+  1- for tid i th @ join next ;
+: run ( k -- )
+  R 1- for
+    clock negate over sample clock +
+    ." @ lock" over 0 .r space over M * . . cr
+  next drop ;
+1 run 2 run 4 run
+bye
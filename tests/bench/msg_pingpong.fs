@@ -0,0 +1,19 @@
+\
+\ message passing - ping-pong latency
+\   VM0 and one task bounce a value back and forth with send/recv
+\   each sample prints "@ name ops ms", collected by tests/bench/msg.py
+\
+20   constant R                     \ samples
+2000 constant M                     \ round trips per sample
+: echo ( -- ) begin recv dup 1 0 send 0< until ;
+' echo task constant pp
+pp start
+: trip ( n -- ) 1 pp send recv drop ;
+: sample ( -- ) M 1- for i trip next ;
+: run ( -- )
+  R 1- for
+    clock negate sample clock +
+    ." @ pingpong " M . . cr
+  next ;
+run -1 trip pp join
+bye
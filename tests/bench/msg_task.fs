@@ -0,0 +1,28 @@
+\
+\ message passing - task life cycle overhead
+\   task: create, start, join an empty task
+\   pull: create, start, and pull one result from a task
+\   spawn: start a future and await its result
+\   each sample prints "@ name ops ms", collected by tests/bench/msg.py
+\
+20  constant R                      \ samples
+5000 constant M                     \ tasks per sample
+: nop ( -- ) ;
+: one ( -- n ) 1 ;
+' nop constant xn
+' one constant xo
+: tsk   ( -- ) xn task dup start join ;
+: tpull ( -- ) xo task dup start 1 swap pull drop ;
+: fut   ( -- ) xo spawn 1 swap await drop ;
+' tsk   constant x1
+' tpull constant x2
+' fut   constant x3
+: time ( xt -- ms ) clock negate swap M 1- for dup exec next drop clock + ;
+: run ( -- )
+  R 1- for
+    ." @ task "  M . x1 time . cr
+    ." @ pull "  M . x2 time . cr
+    ." @ spawn " M . x3 time . cr
+  next ;
+run
+bye
@@ -0,0 +1,22 @@
+\
+\ pipeline throughput - 3 trivial stages, N items, by batch size
+\   a smaller batch means more hand-offs (and wakeups) per item
+\
+100000 constant N
+variable #p
+: s1 ( v -- v' ) 1+ ;
+: s2 ( v -- v' ) 2* ;
+: s3 ( v -- v' ) 1- ;
+: feed  ( -- ) N 0 do i #p @ >pipe loop #p @ pipe-close ;
+' feed constant xf
+: drain ( -- ) begin #p @ pipe> while drop repeat ;
+: run ( p -- )
+  #p ! clock negate
+  xf task start drain
+  clock +
+  ." ms=" dup . ." items/ms=" N swap 1 max / . cr
+  #p @ .pipe 50 ms ;                \ let stage VMs return to the pool
+1   batch ' s1 ' s2 ' s3 3 pipeline p1   .( batch=1 )   p1 run
+16  batch ' s1 ' s2 ' s3 3 pipeline p16  .( batch=16 )  p16 run
+256 batch ' s1 ' s2 ' s3 3 pipeline p256 .( batch=256 ) p256 run
+bye
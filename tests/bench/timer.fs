@@ -0,0 +1,26 @@
+\
+\ timer jitter - how late sleepers and periodic words wake up
+\   3 tasks each sleep 1ms 200 times, while 2 words run every 5ms
+\   and a busy task spins, then the lateness histogram is shown
+\   VM0, busy and the sleepers take 5 of the 7 task VMs of the default
+\   E4_VM_POOL_SZ=8, leaving one for each periodic word, so the missed
+\   column should read 0; a firing that finds no free VM is missed
+\
+variable spins
+variable #run
+: nap   ( -- ) 199 for 1 ms next ;
+: busy  ( -- ) begin 1 spins +! yield #run @ 0= until ;
+: beat  ( -- ) ;
+' nap  constant xn
+' beat constant xb
+: fork ( xt k -- f1 .. fk ) 1- for dup spawn swap next drop ;
+: reap ( f1 .. fk k -- ) 1- for 0 swap await next ;
+1 #run !
+' busy task start
+xb 5 every constant h1
+xb 5 every constant h2
+clock negate xn 3 fork 3 reap clock +
+h1 cancel h2 cancel 0 #run !
+.( elapsed ms=) . .( spins=) spins ? cr
+.jitter
+bye
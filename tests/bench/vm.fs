@@ -0,0 +1,37 @@
+\
+\ interpreter benchmarks - dispatch, calls, arithmetic, stack, memory, output
+\   each sample prints "@ name ops ms", collected by tests/bench/vm.py
+\   (compile speed and startup time are measured by vm.py itself)
+\
+10 constant R                               \ samples
+variable v
+: inner    ( -- ) 9999 for next ;           \ nested empty loops
+: dispatch ( -- ) 9999 for inner next ;
+: nop      ( -- ) ;
+: nops     ( -- ) 99999 for nop next ;
+: calls    ( -- ) 99 for nops next ;
+: arith1   ( -- ) 0 99999 for i 3 * 7 + 5 mod + next drop ;
+: arith    ( -- ) 29 for arith1 next ;
+: stack1   ( -- ) 1 2 3 99999 for swap rot over drop dup drop -rot next drop drop drop ;
+: stack    ( -- ) 29 for stack1 next ;
+: mem1     ( -- ) 99999 for i v ! v @ 1+ v ! v @ drop next ;
+: mem      ( -- ) 19 for mem1 next ;
+: str      ( -- ) 99999 for ." hello, world " i . cr next ;
+' dispatch constant x1
+' calls    constant x2
+' arith    constant x3
+' stack    constant x4
+' mem      constant x5
+' str      constant x6
+: time ( xt -- ms ) clock negate swap exec clock + ;
+: run ( -- )
+  R 1- for
+    x1 time ." @ dispatch 100000000 " . cr
+    x2 time ." @ calls 10000000 "     . cr
+    x3 time ." @ arith 3000000 "     . cr
+    x4 time ." @ stack 3000000 "     . cr
+    x5 time ." @ mem 2000000 "       . cr
+    x6 time ." @ str 100000 "        . cr
+  next ;
+run
+bye
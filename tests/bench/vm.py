@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+#
+# interpreter benchmarks - run tests/bench/vm.fs, time compile and startup,
+# report median/min as JSON
+#
+#   usage: python3 tests/bench/vm.py [eforth] [-n runs] [-o out.json]
+#
+#   vm.fs prints sample lines "@ name ops ms", one per timed batch;
+#   compile times N colon definitions inside one process, and startup
+#   is the wall time of an eforth that only says bye
+#
+import argparse, json, os, statistics, subprocess, sys, time
+from msg import HERE, feed, run
+
+NDEF = 5000                             # colon words per compile sample
+
+def compile_src(n):                     # each word calls the one before
+    s = [': w0 ;']
+    s += [': w%d ( n -- n ) dup 1+ swap drop w%d ;' % (i, i - 1) for i in range(1, n)]
+    return 'clock\n' + '\n'.join(s) + \
+        '\nclock swap - .( @ compile %d ) . cr\nbye\n' % n
+
+def startup(exe, k):                    # msec to start, load, and quit
+    t = []
+    for _ in range(k):
+        t0 = time.perf_counter()
+        subprocess.run([exe], input='bye\n', capture_output=True, text=True)
+        t.append(1000.0 * (time.perf_counter() - t0))
+    return t
+
+def stat(ops, ms):
+    return {
+        'samples': len(ms),
+        'ops':     ops[0],
+        'min':     round(float(min(ms)), 3),
+        'median':  round(float(statistics.median(ms)), 3),
+        'ns_per_op': round(1e6 * statistics.median(ms) / ops[0], 3),
+    }
+
+def main():
+    ap = argparse.ArgumentParser(description='eForth interpreter benchmarks')
+    ap.add_argument('exe', nargs='?', default=os.path.join(HERE, '..', 'eforth'))
+    ap.add_argument('-n', '--runs', type=int, default=1, help='runs of vm.fs')
+    ap.add_argument('-o', '--out', help='write JSON here instead of stdout')
+    ap.add_argument('-t', '--timeout', type=int, default=300, help='seconds per run')
+    a = ap.parse_args()
+
+    bench = {}                          # name => ([ops], [ms])
+    def add(smp):
+        for name, n, t in smp:
+            b = bench.setdefault(name, ([], []))
+            b[0].append(n); b[1].append(t)
+    try:
+        for _ in range(a.runs):
+            smp = run(a.exe, os.path.join(HERE, 'vm.fs'), a.timeout)
+            if not smp: sys.exit('%s: no samples from vm.fs' % a.exe)
+            add(smp)
+        src = compile_src(NDEF)
+        for _ in range(5 * a.runs):
+            add(feed(a.exe, src, a.timeout))
+    except subprocess.TimeoutExpired:
+        sys.exit('%s: timed out after %ds' % (a.exe, a.timeout))
+    k = 10 * a.runs
+    bench['startup'] = ([1] * k, startup(a.exe, k))
+
+    rpt = {
+        'unit':  'ms',
+        'time':  time.strftime('%Y-%m-%dT%H:%M:%S'),
+        'cpus':  os.cpu_count(),
+        'runs':  a.runs,
+        'bench': { k: stat(*v) for k, v in bench.items() },
+    }
+    js = json.dumps(rpt, indent=2)
+    if a.out:
+        with open(a.out, 'w') as f: f.write(js + '\n')
+    else:
+        print(js)
+
+if __name__ == '__main__':
+    main()
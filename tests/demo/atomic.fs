@@ -0,0 +1,23 @@
+\
+\ atomic words - shared counters without lock/unlock
+\
+4 constant K                        \ number of tasks
+1000 constant N                     \ updates per task
+variable cnt
+variable flags
+variable spin                       \ 0=free, 1=taken
+variable sum
+: inc ( -- ) N 1- for 1 cnt atomic+! next ;
+: grab ( -- ) begin 0 1 spin cas until ;           \ cas spin-lock
+: add ( -- ) N 1- for grab 1 sum +! 0 spin atomic! next ;
+: mark ( -- ) 1 rank lshift flags fetch-or drop ;
+: job ( -- ) inc add mark ;
+' job constant xt
+: fork ( k -- f1 .. fk ) 1- for xt spawn next ;
+: reap ( f1 .. fk k -- ) 1- for 0 swap await next ;
+K fork K reap
+.( atomic+! cnt=) cnt atomic@ . cr  \ 4000
+.( cas lock sum=) sum ? cr          \ 4000
+: bits ( n -- c ) 0 swap begin dup while dup 1 and rot + swap 1 rshift repeat drop ;
+.( tasks=) 0 flags fetch-and bits . cr   \ 4, one bit per rank
+bye
@@ -0,0 +1,15 @@
+\
+\ channels - bounded queues between tasks, chan! waits while full,
+\   chan@ waits while empty, select takes from whichever has data
+\
+4 channel c1                        \ capacity 4
+4 channel c2
+: p1 ( -- ) 9 for i c1 chan! next ; \ 10 items, blocks when c1 full
+: p2 ( -- ) 9 for i 100 + c2 chan! next ;
+' p1 task start
+' p2 task start
+: drain ( -- sum ) 0 19 for c1 c2 2 select drop + next ;
+.( select sum=) drain . cr          \ 45 + 1045 = 1090
+.( empty? ) c1 chan@? . cr           \ nothing left, false
+7 c1 chan!? . c1 chan@ . cr         \ -1 7
+bye
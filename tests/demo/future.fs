@@ -0,0 +1,17 @@
+\
+\ futures - spawn starts a task and returns a handle,
+\   ready? polls it, await takes its results off its stack
+\
+: fib ( n -- f ) dup 2 < if exit then dup 1- fib swap 2 - fib + ;
+: job1 ( -- n ) 24 fib ;
+: job2 ( -- n ) 20 fib ;
+: job3 ( -- a b ) 10 fib 11 fib ;
+' job1 spawn constant f1             \ start all three
+' job2 spawn constant f2
+' job3 spawn constant f3
+: poll ( -- ) begin f2 ready? 0= while yield repeat ;
+poll .( job2 ready ) cr
+.( fib 24=) 1 f1 await . cr
+.( fib 20=) 1 f2 await . cr
+.( fib 10, 11=) 2 f3 await swap . . cr
+bye
@@ -0,0 +1,24 @@
+\
+\ green threads - more waiting tasks than worker threads
+\   tasks blocked in recv, ms, or join give their worker back to the pool
+\   with the default pool of 8 VMs there are at most 4 workers, so the
+\   6 waiting tasks and the spinner below outnumber them
+\
+6 constant N                        \ number of waiting tasks
+.( tasks=) N 1+ . .( workers=) workers . cr
+create tid N allot                  \ task ids
+variable cnt
+: tick ( -- )                       \ waiting task
+  recv                                \ park until a message arrives
+  100 ms                              \ sleep without holding a worker
+  lock cnt +! unlock ;
+: busy ( -- ) 99 for yield next ;   \ cooperative spinner
+' tick constant xt
+: launch ( -- ) N 1- for xt task dup tid i th ! start next ;
+: feed  ( -- ) N 1- for i 1+ 1 tid i th @ send next ;
+: jn    ( -- ) N 1- for tid i th @ join next ;
+launch 200 ms                        \ all tasks parked in recv
+' busy task start
+feed jn
+.( total=) cnt ? cr                 \ 1+2+..+6 = 21
+bye
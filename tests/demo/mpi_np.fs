@@ -0,0 +1,17 @@
+\
+\ multi-process message passing - pass a token around all nodes
+\   run: ./tests/eforth -np 4 < tests/demo/mpi_np.fs
+\   VM v of node r is tid (r+1)*8+v (E4_VM_POOL_SZ=8), gid builds one
+\   send to a VM on another node goes through shared memory, recv as usual
+\   task ids below 8 are local on every node, so mpi.fs runs as is per node
+\
+: next-node ( -- tid ) 0 node 1+ nodes mod gid ;  \ VM0 of the next node
+: pass ( -- ) recv node + 1 next-node send ;      \ add our rank, pass on
+: kick ( -- )                                   \ node 0 starts the token
+  0 1 next-node send
+  recv ." ring of " nodes . ." nodes, sum of ranks=" . cr ;
+: ring ( -- )
+  nodes 2 < if ." run with -np 2 or more" cr
+  else node if pass else kick then then ;
+ring
+bye
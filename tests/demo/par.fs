@@ -0,0 +1,21 @@
+\
+\ n par{ .. | .. }par - inline fork/join inside a colon word
+\   each branch runs on its own VM with a copy of the stack, joined at }par
+\   the top n cells are inputs of every branch, and consumed at }par
+\   what each branch leaves in their place is pushed, in branch order
+\
+: sum ( n -- s ) 0 swap for i + next ;
+: both ( n -- a b ) 1 par{ sum | 2* sum }par ;
+1000 both .( sums=) . . cr                     \ 2001000 500500
+: twice ( n -- a b ) 1 par{ 2* | 3 + }par ;
+5 twice .( in place=) . . cr                   \ 8 10
+variable cnt
+: hit ( -- ) 1 cnt atomic+! ;
+: four ( -- ) 0 par{ hit | hit | 0 par{ hit | hit }par }par ;
+four .( hits=) cnt ? cr                        \ nested blocks, 4
+: idx ( -- ) 3 0 do i 1 par{ 10 * | 1+ }par + . loop ;
+.( in a loop=) idx cr                          \ 1 12 23, i of the do
+: rows ( -- ) 0 par{ lock ." row a" cr unlock | lock ." row b" cr unlock }par ;
+rows                                           \ side effects only, nothing added
+see both
+bye
@@ -0,0 +1,18 @@
+\
+\ parallel counted loop - pdo..ploop splits the range onto pool VMs
+\   each chunk has its own i, TOS of each chunk is summed into caller's TOS
+\
+: sum ( n -- s ) 0 swap 0 pdo i + ploop ;
+.( sum 0..999=) 1000 sum . cr             \ 499500
+100 constant N
+create sq N allot
+: squares ( -- ) N 0 pdo i dup * sq i th ! ploop ;
+: verify  ( -- f ) 0 N 0 do sq i th @ + loop ;
+10 grain                            \ 10 iterations per chunk
+squares
+.( sum of squares=) verify . cr            \ 328350
+.( sum 0..9999=) 10000 sum . cr           \ 49995000, fits a 32-bit cell
+0 grain                             \ back to auto, one chunk per worker
+: grid ( -- s ) 0 3 0 do 4 0 pdo j + ploop loop ;
+.( sum of j over 3x4=) grid . cr           \ j is the outer index, 12
+bye
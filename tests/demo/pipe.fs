@@ -0,0 +1,15 @@
+\
+\ pipeline - each stage runs on its own VM, items handed off in batches
+\
+variable acc
+: parse  ( v -- v' ) 2* ;           \ stage 1
+: xform  ( v -- v' ) 1+ ;           \ stage 2
+: aggr   ( v -- v' ) acc +! acc @ ; \ stage 3, running total
+16 batch
+' parse ' xform ' aggr 3 pipeline pp
+: feed  ( -- ) 1000 0 do i pp >pipe loop pp pipe-close ;
+: drain ( -- v ) 0 begin pp pipe> while nip repeat ;
+' feed task start                   \ feed and drain concurrently
+.( total=) drain . cr               \ sum of 2i+1, i<1000 = 1000000
+pp .pipe
+bye
@@ -0,0 +1,20 @@
+\
+\ timers - after runs a word once, every runs it periodically,
+\   a task in ms parks until the timer thread wakes it
+\
+variable once
+variable never
+variable ticks
+: fired ( -- ) 1 once ! ;
+: nope  ( -- ) 1 never ! ;
+: tick  ( -- ) 1 ticks atomic+! ;
+' fired 50 after drop
+' nope 50 after cancel              \ pending one-shot, never runs
+' tick 10 every constant h          \ every 10ms
+: nap ( -- ) 9 for 10 ms next ;     \ sleeps without holding a worker
+' nap task dup start join
+h cancel
+.( once=) once ? cr                 \ 1
+.( never=) never ? cr               \ 0
+.( ticks>=8 ) ticks @ 7 > . cr      \ -1, about 10 ticks in 100ms
+bye